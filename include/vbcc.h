@@ -33,6 +33,7 @@ namespace vbcc
   // Region types.
   inline const auto RegionRC = TokenDef("rc");
   inline const auto RegionArena = TokenDef("arena");
+  inline const auto RegionGC = TokenDef("gc");
 
   // Types.
   inline const auto None = TokenDef("none");
@@ -91,6 +92,7 @@ namespace vbcc
   inline const auto Lookup = TokenDef("lookup");
   inline const auto Call = TokenDef("call");
   inline const auto FFI = TokenDef("ffi");
+  inline const auto FFIMany = TokenDef("ffimany");
   inline const auto When = TokenDef("when");
   inline const auto Typetest = TokenDef("typetest");
 
@@ -195,6 +197,7 @@ namespace vbcc
   inline const auto Symbols = TokenDef("symbols");
   inline const auto InitFunc = TokenDef("initfunc");
   inline const auto Vararg = TokenDef("vararg");
+  inline const auto Blocking = TokenDef("blocking");
   inline const auto Union = TokenDef("union");
   inline const auto TupleType = TokenDef("tupletype");
   inline const auto Field = TokenDef("field");
@@ -227,7 +230,7 @@ namespace vbcc
   inline const auto Kind = TokenDef("kind");
   inline const auto ValueSrc = TokenDef("valuesrc");
 
-  inline const auto wfRegionType = RegionRC | RegionArena;
+  inline const auto wfRegionType = RegionRC | RegionArena | RegionGC;
 
   inline const auto wfIntType =
     I8 | I16 | I32 | I64 | U8 | U16 | U32 | U64 | ILong | ULong | ISize | USize;
@@ -258,7 +261,7 @@ namespace vbcc
     RegionArrayConst | Copy | Move | Drop | Freeze | Pin | Unpin | Merge |
     FFIStruct | FFILoad | FFIStore | RegisterRef | FieldRef | ArrayRef |
     ArrayRefConst | Load | Store | Lookup | Arg | Call | CallDyn | TryCallDyn |
-    FFI | When | WhenDyn | GetRaise | SetRaise | wfBinop | wfUnop | wfConst |
+    FFI | FFIMany | When | WhenDyn | GetRaise | SetRaise | wfBinop | wfUnop | wfConst |
     Typetest | MakeCallback | CodePtrCallback | FreeCallback | MemoSlot |
     ArrayCopy | ArrayFill | ArrayCompare;
 
@@ -290,7 +293,8 @@ namespace vbcc
     | (Symbols <<= Symbol++)
     | (Symbol <<=
         SymbolId * (Lhs >>= String) * (Rhs >>= String) *
-        (Vararg >>= Vararg | None) * FFIParams * (Return >>= wfType))
+        (Vararg >>= Vararg | None) * (Blocking >>= Blocking | None) *
+        FFIParams * (Return >>= wfType))
     | (FFIParams <<= wfType++)
     | (Type <<= TypeId * (Type >>= wfType))[TypeId]
     | (Primitive <<= (Type >>= wfBuiltinType) * Methods)
@@ -349,6 +353,7 @@ namespace vbcc
     | (CallDyn <<= wfDst * wfSrc * Args)
     | (TryCallDyn <<= wfDst * wfSrc * Args)
     | (FFI <<= wfDst * SymbolId * Args)
+    | (FFIMany <<= wfDst * SymbolId * Args)
     | (When <<= wfDst * FunctionId * Args * Cown)
     | (WhenDyn <<= wfDst * wfSrc * Args * Cown)
     | (Args <<= Arg++)
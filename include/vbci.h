@@ -24,6 +24,11 @@ namespace vbci
   inline const auto CallbackMethodId = size_t(1);
   inline const auto DynId = uint32_t(-1);
 
+  // Symbol flags. A blocking symbol is followed by the type ID of the cown
+  // that its calls return.
+  inline const auto SymbolVararg = size_t(1);
+  inline const auto SymbolBlocking = size_t(2);
+
   // Op codes are ULEB128 encoded. Arguments are ULEB128 encoded unless they're
   // known to be signed integers (zigzag SLEB128) or floats (bitcast zigzag
   // ULEB128).
@@ -440,6 +445,54 @@ namespace vbci
     // Arg4 = b offset.
     // Arg5 = length.
     ArrayCompare,
+
+    // Call an FFI symbol once for each element of a set of arrays, looping
+    // natively. The arguments are the output array, followed by one array for
+    // each parameter. Each array holds primitives of the symbol's return or
+    // parameter type, and all have the same length. Returns None.
+    // Arg0 = dst (none).
+    // Arg1 = symbol ID.
+    FFIMany,
+
+    // Superinstructions. Each has the same effect as the sequence it replaces,
+    // including writing every intermediate register.
+
+    // Compare and jump to a label depending on the result.
+    // Arg0 = dst (boolean result).
+    // Arg1 = left-hand side src.
+    // Arg2 = right-hand side src.
+    // Arg3 = on-true label.
+    // Arg4 = on-false label.
+    CondEq,
+    CondNe,
+    CondLt,
+    CondLe,
+    CondGt,
+    CondGe,
+
+    // Add or subtract an immediate value.
+    // Arg0 = dst.
+    // Arg1 = left-hand side src.
+    // Arg2 = dst for the immediate value.
+    // Arg3 = value type.
+    // Arg4 = primitive value.
+    AddConst,
+    SubConst,
+
+    // Create a reference to a field in a target object, copying the source,
+    // and load from it.
+    // Arg0 = dst for the field reference.
+    // Arg1 = src.
+    // Arg2 = field ID.
+    // Arg3 = dst.
+    FieldLoad,
+
+    // Set the last argument and call a function.
+    // Arg0 = src for the last argument.
+    // Arg1 = dst.
+    // Arg2 = function ID.
+    ArgMoveCallStatic,
+    ArgCopyCallStatic,
   };
 
   enum class ValueType : uint8_t
@@ -485,7 +538,8 @@ namespace vbci
   enum class RegionType : uint8_t
   {
     RegionRC,
-    RegionArena
+    RegionArena,
+    RegionGC
   };
 
   enum class DIOp : uint8_t
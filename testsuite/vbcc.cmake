@@ -2,6 +2,11 @@
 macro(toolinvoke ARGS testfile outputdir)
   get_filename_component(test_name ${testfile} NAME_WE)
   set(${ARGS} build ${testfile} -b ${outputdir}/${test_name}.vbc -o ${outputdir}/${test_name}_final.trieste)
+  # Compiler flags for a test, one per line, in <test>.args.
+  if(EXISTS ${WORKING_DIR}/${test_name}.args)
+    file(STRINGS ${WORKING_DIR}/${test_name}.args test_flags)
+    list(APPEND ${ARGS} ${test_flags})
+  endif()
 endmacro()
 
 # Regular expression to match test files
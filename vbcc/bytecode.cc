@@ -98,6 +98,8 @@ namespace vbcc
       return +RegionType::RegionRC;
     else if (region == RegionArena)
       return +RegionType::RegionArena;
+    else if (region == RegionGC)
+      return +RegionType::RegionGC;
 
     assert(false);
     return size_t(-1);
@@ -510,7 +512,7 @@ namespace vbcc
 
   void Bytecode::gen(std::filesystem::path output, bool strip)
   {
-    wf::push_back(wfIR);
+    wf::push_back(wfFused);
 
     if (output.empty())
       output = "out.vbc";
@@ -640,13 +642,18 @@ namespace vbcc
       hdr << uleb(*get_library_id(symbol->parent(Lib)))
           << uleb(ST::exec().string(symbol / Lhs))
           << uleb(ST::exec().string(symbol / Rhs))
-          << uleb(((symbol / Vararg) == Vararg) ? 1 : 0)
+          << uleb(
+               (((symbol / Vararg) == Vararg) ? SymbolVararg : 0) |
+               (((symbol / Blocking) == Blocking) ? SymbolBlocking : 0))
           << uleb((symbol / FFIParams)->size());
 
       for (auto& param : *(symbol / FFIParams))
         hdr << uleb(typ(param));
 
       hdr << uleb(typ(symbol / Return));
+
+      if ((symbol / Blocking) == Blocking)
+        hdr << uleb(typ(Cown << clone(symbol / Return)));
     }
 
     // Functions.
@@ -720,6 +727,36 @@ namespace vbcc
           onearg(arg);
       };
 
+      // A value type followed by a literal of that type.
+      auto lit = [&](Node stmt) {
+        auto t = stmt / Type;
+        auto v = stmt / Rhs;
+        code << uleb(+val(t));
+
+        if (t == Bool)
+          code << uleb(((v == True) ? 1 : 0));
+        else if (t == I8)
+          code << sleb(from_chars_sep_v<int8_t>(v));
+        else if (t == U8)
+          code << uleb(from_chars_sep_v<uint8_t>(v));
+        else if (t == I16)
+          code << sleb(from_chars_sep_v<int16_t>(v));
+        else if (t == U16)
+          code << uleb(from_chars_sep_v<uint16_t>(v));
+        else if (t == I32)
+          code << sleb(from_chars_sep_v<int32_t>(v));
+        else if (t == U32)
+          code << uleb(from_chars_sep_v<uint32_t>(v));
+        else if (t->in({I64, ILong, ISize}))
+          code << sleb(from_chars_sep_v<int64_t>(v));
+        else if (t->in({U64, ULong, USize, Ptr}))
+          code << uleb(from_chars_sep_v<uint64_t>(v));
+        else if (t == F32)
+          code << sleb(from_chars_sep_v<float>(v));
+        else if (t == F64)
+          code << sleb(from_chars_sep_v<double>(v));
+      };
+
       constexpr size_t no_value = size_t(-1);
       size_t di_file = no_value;
       size_t di_offset = 0;
@@ -820,72 +857,41 @@ namespace vbcc
 
           if (stmt == Const)
           {
-            auto t = stmt / Type;
-            auto v = stmt / Rhs;
-
-            if (t == None)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t));
-            }
-            else if (t == Bool)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t));
-
-              if ((stmt / Rhs) == True)
-                code << uleb(1);
-              else
-                code << uleb(0);
-            }
-            else if (t == I8)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << sleb(from_chars_sep_v<int8_t>(v));
-            }
-            else if (t == U8)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << uleb(from_chars_sep_v<uint8_t>(v));
-            }
-            else if (t == I16)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << sleb(from_chars_sep_v<int16_t>(v));
-            }
-            else if (t == U16)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << uleb(from_chars_sep_v<uint16_t>(v));
-            }
-            else if (t == I32)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << sleb(from_chars_sep_v<int32_t>(v));
-            }
-            else if (t == U32)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << uleb(from_chars_sep_v<uint32_t>(v));
-            }
-            else if (t->in({I64, ILong, ISize}))
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << sleb(from_chars_sep_v<int64_t>(v));
-            }
-            else if (t->in({U64, ULong, USize, Ptr}))
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << uleb(from_chars_sep_v<uint64_t>(v));
-            }
-            else if (t == F32)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << sleb(from_chars_sep_v<float>(v));
-            }
-            else if (t == F64)
-            {
-              code << uleb(+Op::Const) << dst(stmt) << uleb(+val(t))
-                   << sleb(from_chars_sep_v<double>(v));
-            }
+            code << uleb(+Op::Const) << dst(stmt);
+            lit(stmt);
+          }
+          else if (stmt == ConstOp)
+          {
+            auto c = stmt / Lhs;
+            auto op = stmt / Rhs;
+
+            if (op == Add)
+              code << uleb(+Op::AddConst);
+            else
+              code << uleb(+Op::SubConst);
+
+            code << dst(op) << lhs(op) << dst(c);
+            lit(c);
+          }
+          else if (stmt == FieldLoad)
+          {
+            auto ref = stmt / Lhs;
+            auto load = stmt / Rhs;
+            code << uleb(+Op::FieldLoad) << dst(ref) << src(ref / Arg)
+                 << fld(ref) << dst(load);
+          }
+          else if (stmt == ArgCall)
+          {
+            auto arg = stmt / Lhs;
+            auto call = stmt / Rhs;
+            args(call / Args);
+
+            if ((arg / Type) == ArgMove)
+              code << uleb(+Op::ArgMoveCallStatic);
+            else
+              code << uleb(+Op::ArgCopyCallStatic);
+
+            code << src(arg) << dst(call) << fn(call);
           }
           else if (stmt == ConstStr)
           {
@@ -1063,6 +1069,12 @@ namespace vbcc
             code << uleb(+Op::FFI) << dst(stmt)
                  << uleb(*get_symbol_id(stmt / SymbolId));
           }
+          else if (stmt == FFIMany)
+          {
+            args(stmt / Args);
+            code << uleb(+Op::FFIMany) << dst(stmt)
+                 << uleb(*get_symbol_id(stmt / SymbolId));
+          }
           else if (stmt == FFIStruct)
           {
             code << uleb(+Op::FFIStruct) << dst(stmt) << uleb(typ(stmt / Type));
@@ -1387,6 +1399,28 @@ namespace vbcc
         {
           code << uleb(+Op::Raise) << dst(term);
         }
+        else if (term == CmpCond)
+        {
+          auto cmp = term / Lhs;
+          auto cond = term / Rhs;
+          auto t = *func_state.get_label_id(cond / Lhs);
+          auto f = *func_state.get_label_id(cond / Rhs);
+
+          if (cmp == Eq)
+            code << uleb(+Op::CondEq);
+          else if (cmp == Ne)
+            code << uleb(+Op::CondNe);
+          else if (cmp == Lt)
+            code << uleb(+Op::CondLt);
+          else if (cmp == Le)
+            code << uleb(+Op::CondLe);
+          else if (cmp == Gt)
+            code << uleb(+Op::CondGt);
+          else
+            code << uleb(+Op::CondGe);
+
+          code << dst(cmp) << lhs(cmp) << rhs(cmp) << uleb(t) << uleb(f);
+        }
         else if (term == Cond)
         {
           auto t = *func_state.get_label_id(term / Lhs);
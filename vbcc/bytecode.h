@@ -69,6 +69,8 @@ namespace vbcc
   {
     std::vector<std::filesystem::path> source_paths;
     bool error = false;
+    bool fuse = false;
+    bool stack_promote = false;
     Node top;
 
     std::unordered_map<ST::Index, size_t> type_ids;
@@ -18,6 +18,25 @@ namespace vbcc
   inline const auto Comma = TokenDef(",");
   inline const auto Colon = TokenDef(":");
 
+  // Superinstructions, introduced by the fuse pass. Each one wraps the
+  // statements it replaces, so code generation can still see their operands.
+  inline const auto CmpCond = TokenDef("cmpcond");
+  inline const auto ConstOp = TokenDef("constop");
+  inline const auto FieldLoad = TokenDef("fieldload");
+  inline const auto ArgCall = TokenDef("argcall");
+
+  // clang-format off
+  inline const auto wfFused =
+      wfIR
+    | (Label <<= LabelId * Body * (Return >>= wfTerminator | CmpCond))
+    | (Body <<= (wfStatement | ConstOp | FieldLoad | ArgCall)++)
+    | (CmpCond <<= (Lhs >>= Eq | Ne | Lt | Le | Gt | Ge) * (Rhs >>= Cond))
+    | (ConstOp <<= (Lhs >>= Const) * (Rhs >>= Add | Sub))
+    | (FieldLoad <<= (Lhs >>= FieldRef) * (Rhs >>= Load))
+    | (ArgCall <<= (Lhs >>= Arg) * (Rhs >>= Call))
+    ;
+  // clang-format on
+
   const auto Binop =
     T(Add,
       Sub,
@@ -101,6 +120,7 @@ namespace vbcc
       CallDyn,
       TryCallDyn,
       FFI,
+      FFIMany,
       When,
       WhenDyn,
       GetRaise,
@@ -132,6 +152,8 @@ namespace vbcc
   PassDef liveness(std::shared_ptr<Bytecode> state);
   PassDef typecheck(std::shared_ptr<Bytecode> state);
   PassDef optimize(std::shared_ptr<Bytecode> state);
+  PassDef escape(std::shared_ptr<Bytecode> state);
+  PassDef fuse(std::shared_ptr<Bytecode> state);
 
   Node err(const std::string& msg);
   Node err(Node node, const std::string& msg);
@@ -18,22 +18,35 @@ int main(int argc, char** argv)
      validids(state),
      typecheck(state),
      optimize(state),
-     liveness(state)},
+     liveness(state),
+     escape(state),
+     fuse(state)},
     parser()};
 
   struct Options : public trieste::Options
   {
     std::filesystem::path path;
     std::filesystem::path bytecode_file;
+    Bytecode& state;
     bool strip = false;
     bool build = false;
 
+    Options(Bytecode& state) : state(state) {}
+
     void configure(CLI::App& cli) override
     {
       cli.add_option(
         "-b,--bytecode", bytecode_file, "Output bytecode to this file.");
       cli.add_flag(
         "-s,--strip", strip, "Strip debug information from the bytecode.");
+      cli.add_flag(
+        "--fuse",
+        state.fuse,
+        "Fuse common op sequences into superinstructions.");
+      cli.add_flag(
+        "--stack-promote",
+        state.stack_promote,
+        "Allocate non-escaping temporaries on the stack.");
 
       cli.callback([this, &cli]() {
         build = cli.parsed();
@@ -54,7 +67,7 @@ int main(int argc, char** argv)
     }
   };
 
-  Options opts;
+  Options opts(*state);
   Driver d(reader, &opts);
   auto r = d.run(argc, argv);
 
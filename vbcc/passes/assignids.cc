@@ -35,6 +35,7 @@ namespace vbcc
                                (_(Symbol) / Lhs)->location().view()) &&
               ((existing / Rhs)->location().view() ==
                (_(Symbol) / Rhs)->location().view()) &&
+              ((existing / Blocking) == (_(Symbol) / Blocking)->type()) &&
               IRSubtype.invariant(top, er, nr) &&
               std::equal(ep->begin(),
                          ep->end(),
@@ -0,0 +1,238 @@
+#include "../lang.h"
+
+namespace vbcc
+{
+  static bool is_primitive(Node t)
+  {
+    return t->in(
+      {None,
+       Bool,
+       I8,
+       I16,
+       I32,
+       I64,
+       U8,
+       U16,
+       U32,
+       U64,
+       ILong,
+       ULong,
+       ISize,
+       USize,
+       F32,
+       F64,
+       Ptr});
+  }
+
+  // An allocation can move to the stack if doing so can't change what the
+  // program observes. Its class has no finalizer and only primitive fields, so
+  // keeping it until the frame returns doesn't delay any other release.
+  static bool promotable(Bytecode& state, Node stmt)
+  {
+    if (stmt->in({NewArray, NewArrayConst}))
+      return is_primitive(stmt / Type);
+
+    auto cls = state.classes.at(*state.get_class_id(stmt / ClassId));
+
+    for (auto method : *(cls / Methods))
+    {
+      if ((method / MethodId)->location().view() == "@final")
+        return false;
+    }
+
+    for (auto field : *(cls / Fields))
+    {
+      if (!is_primitive(field / Type))
+        return false;
+    }
+
+    return true;
+  }
+
+  // Returns true if using a register that holds a promoted allocation at this
+  // point doesn't let it outlive the frame.
+  static bool local_use(Node stmt, Node id)
+  {
+    if (stmt->in({Copy, Move, Load, Lookup, Typetest, Len, Eq, Ne, Drop}))
+      return true;
+
+    // A field or element reference into the allocation.
+    if (stmt->in({FieldRef, ArrayRef, ArrayRefConst}))
+      return true;
+
+    // Storing through a reference, but not storing the allocation itself.
+    if (stmt == Store)
+      return id->parent() == stmt;
+
+    return false;
+  }
+
+  PassDef escape(std::shared_ptr<Bytecode> state)
+  {
+    PassDef p{"escape", wfIR, dir::once, {}};
+
+    p.post([state](auto top) {
+      // Stack promotion changes opcodes, so it is opt-in. Don't rewrite a
+      // program that won't be emitted.
+      if (!state->stack_promote || state->error)
+        return 0;
+
+      top->traverse([&](auto node) {
+        if (node == Top)
+          return true;
+
+        if (node != Func)
+          return false;
+
+        auto& func = state->get_func(node / FunctionId);
+        auto regs = func.register_names.size();
+        auto reg = [&](Node id) { return *func.get_register_id(id); };
+
+        Bitset vars(regs);
+
+        for (auto var : *(node / Vars))
+          vars.set(reg(var / LocalId));
+
+        // Stack allocations are only released when the frame returns, so
+        // allocations in a loop stay in the region.
+        auto num_labels = func.labels.size();
+        std::vector<bool> in_loop(num_labels, false);
+
+        for (size_t i = 0; i < num_labels; i++)
+        {
+          std::vector<bool> seen(num_labels, false);
+          std::vector<size_t> wl = func.labels.at(i).succ;
+
+          while (!wl.empty() && !in_loop[i])
+          {
+            auto l = wl.back();
+            wl.pop_back();
+
+            if (l == i)
+              in_loop[i] = true;
+            else if (!seen[l])
+            {
+              seen[l] = true;
+              auto& succ = func.labels.at(l).succ;
+              wl.insert(wl.end(), succ.begin(), succ.end());
+            }
+          }
+        }
+
+        // Find the candidates. Registers are SSA unless they're vars, so each
+        // candidate register is defined once.
+        constexpr auto NoAlloc = size_t(-1);
+        std::vector<Node> allocs;
+        std::vector<bool> escapes;
+        std::vector<size_t> origin(regs, NoAlloc);
+
+        for (auto label : *(node / Labels))
+        {
+          if (in_loop.at(*func.get_label_id(label / LabelId)))
+            continue;
+
+          for (auto stmt : *(label / Body))
+          {
+            if (
+              !stmt->in({New, NewArray, NewArrayConst}) ||
+              vars.test(reg(stmt / LocalId)) || !promotable(*state, stmt))
+              continue;
+
+            origin[reg(stmt / LocalId)] = allocs.size();
+            allocs.push_back(stmt);
+            escapes.push_back(false);
+          }
+        }
+
+        if (allocs.empty())
+          return false;
+
+        auto each_stmt = [&](auto&& fn) {
+          for (auto label : *(node / Labels))
+          {
+            for (auto stmt : *(label / Body))
+              fn(stmt, false);
+
+            fn(label / Return, true);
+          }
+        };
+
+        // Follow copies and references of each allocation to a fixed point.
+        for (bool changed = true; changed;)
+        {
+          changed = false;
+
+          each_stmt([&](Node stmt, bool term) {
+            if (
+              term ||
+              !stmt->in({Copy, Move, FieldRef, ArrayRef, ArrayRefConst}))
+              return;
+
+            auto src = stmt->in({Copy, Move}) ? stmt / Rhs : stmt / Arg / Rhs;
+            auto o = origin.at(reg(src));
+
+            if (o == NoAlloc)
+              return;
+
+            auto dst = reg(stmt / LocalId);
+
+            if (vars.test(dst))
+              escapes[o] = true;
+            else if (origin.at(dst) == NoAlloc)
+            {
+              origin[dst] = o;
+              changed = true;
+            }
+          });
+        }
+
+        // Any other use lets the allocation escape.
+        each_stmt([&](Node stmt, bool term) {
+          Node def;
+
+          if (!term && (stmt != Drop) && !stmt->empty())
+          {
+            if (stmt->front() == LocalId)
+              def = stmt->front();
+          }
+
+          stmt->traverse([&](auto n) {
+            if ((n != LocalId) || (n == def))
+              return true;
+
+            auto o = origin.at(reg(n));
+
+            if ((o != NoAlloc) && (term || !local_use(stmt, n)))
+              escapes[o] = true;
+
+            return false;
+          });
+        });
+
+        for (size_t i = 0; i < allocs.size(); i++)
+        {
+          if (escapes[i])
+            continue;
+
+          auto stmt = allocs[i];
+          Node promoted;
+
+          if (stmt == New)
+            promoted = Stack << *stmt;
+          else if (stmt == NewArray)
+            promoted = StackArray << *stmt;
+          else
+            promoted = StackArrayConst << *stmt;
+
+          stmt->parent()->replace(stmt, promoted);
+        }
+
+        return false;
+      });
+
+      return 0;
+    });
+
+    return p;
+  }
+}
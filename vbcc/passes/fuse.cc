@@ -0,0 +1,110 @@
+#include "../lang.h"
+
+namespace vbcc
+{
+  // Returns true if the two nodes name the same register.
+  static bool same_reg(Node a, Node b)
+  {
+    return a->location().view() == b->location().view();
+  }
+
+  PassDef fuse(std::shared_ptr<Bytecode> state)
+  {
+    PassDef p{"fuse", wfFused, dir::once, {}};
+
+    p.post([state](auto top) {
+      // Superinstructions change code offsets, so they are opt-in. Don't
+      // rewrite a program that won't be emitted.
+      if (!state->fuse || state->error)
+        return 0;
+
+      top->traverse([&](auto node) {
+        if (node->in({Top, Func, FuncOnce, Labels}))
+          return true;
+
+        if (node != Label)
+          return false;
+
+        Node body = node / Body;
+
+        // Fuse adjacent statement pairs in the body. Each fused statement
+        // still writes every register its parts wrote, so no liveness
+        // information is needed.
+        for (auto it = body->begin(); it != body->end(); ++it)
+        {
+          Node stmt = *it;
+          auto next_it = std::next(it);
+
+          if (stmt == Call)
+          {
+            // Pass the last argument as part of the call.
+            Node args = stmt / Args;
+
+            if (args->empty())
+              continue;
+
+            Node arg = args->back();
+            args->erase(std::prev(args->end()), args->end());
+            Node fused = ArgCall ^ stmt;
+            body->replace(stmt, fused);
+            fused << arg << stmt;
+            continue;
+          }
+
+          if (next_it == body->end())
+            break;
+
+          Node next = *next_it;
+
+          Node fused;
+
+          if (
+            (stmt == Const) && next->in({Add, Sub}) &&
+            same_reg(stmt / LocalId, next / Rhs))
+          {
+            // Arithmetic with an immediate.
+            fused = ConstOp ^ stmt;
+          }
+          else if (
+            (stmt == FieldRef) && ((stmt / Arg / Type) == ArgCopy) &&
+            (next == Load) && same_reg(stmt / LocalId, next / Rhs))
+          {
+            // Load directly from a field.
+            fused = FieldLoad ^ stmt;
+          }
+
+          if (!fused)
+            continue;
+
+          body->replace(stmt, fused);
+          body->erase(next_it, std::next(next_it));
+          fused << stmt << next;
+        }
+
+        // Compare and branch.
+        Node term = node / Return;
+
+        if ((term == Cond) && !body->empty())
+        {
+          Node cmp = body->back();
+
+          if (
+            cmp->in({Eq, Ne, Lt, Le, Gt, Ge}) &&
+            same_reg(cmp / LocalId, term / LocalId))
+          {
+            body->erase(std::prev(body->end()), body->end());
+            Node fused = CmpCond ^ term;
+            node->replace(term, fused);
+            fused << cmp << term;
+          }
+        }
+
+        return false;
+      });
+
+      return 0;
+    });
+
+    return p;
+  }
+}
@@ -172,6 +172,7 @@ namespace vbcc
                       FieldRef,
                       ArrayRefConst,
                       FFI,
+                      FFIMany,
                       FFIStruct,
                       GetRaise,
                       Const_E,
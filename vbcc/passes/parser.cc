@@ -5,7 +5,7 @@ namespace vbcc
   const auto wfParserTokens = Lib | Type | Primitive | Class | Func | Vars |
     Source | GlobalId | LocalId | LabelId | Equals | LParen | RParen |
     LBracket | RBracket | Comma | Colon | Union | TupleType | Vararg |
-    wfRegionType | wfPrimitiveType | Dyn | Ref | Cown | wfStatement |
+    Blocking | wfRegionType | wfPrimitiveType | Dyn | Ref | Cown | wfStatement |
     wfTerminator | wfLiteral | String | RawString;
 
   // clang-format off
@@ -38,6 +38,7 @@ namespace vbcc
         // Region types.
         "rc\\b" >> [](auto& m) { m.add(RegionRC); },
         "arena\\b" >> [](auto& m) { m.add(RegionArena); },
+        "gc\\b" >> [](auto& m) { m.add(RegionGC); },
 
         // Types.
         "none\\b" >> [](auto& m) { m.add(None); },
@@ -83,6 +84,8 @@ namespace vbcc
         "call\\b" >> [](auto& m) { m.add(Call); },
 
         "ffi\\b" >> [](auto& m) { m.add(FFI); },
+        "ffimany\\b" >> [](auto& m) { m.add(FFIMany); },
+        "blocking\\b" >> [](auto& m) { m.add(Blocking); },
         "when\\b" >> [](auto& m) { m.add(When); },
         "getraise\\b" >> [](auto& m) { m.add(GetRaise); },
         "setraise\\b" >> [](auto& m) { m.add(SetRaise); },
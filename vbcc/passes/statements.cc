@@ -16,7 +16,7 @@ namespace vbcc
   const auto FloatLiteral = T(Float, HexFloat);
 
   const auto Dst = T(LocalId)[LocalId] * T(Equals);
-  const auto RegionType = T(RegionRC, RegionArena);
+  const auto RegionType = T(RegionRC, RegionArena, RegionGC);
   const auto SymbolParams = T(LParen) *
     (~(TypePat * (T(Comma) * TypePat)++))[Params] *
     ~(T(Comma) * T(Vararg)[Vararg]) * T(RParen);
@@ -261,12 +261,14 @@ namespace vbcc
           },
 
         // FFI symbols.
-        T(GlobalId)[GlobalId] * T(Equals) * T(String)[Lhs] * ~T(String)[Rhs] *
-            SymbolParams * T(Colon) * TypePat[Type] >>
+        T(GlobalId)[GlobalId] * T(Equals) * ~T(Blocking)[Blocking] *
+            T(String)[Lhs] * ~T(String)[Rhs] * SymbolParams * T(Colon) *
+            TypePat[Type] >>
           [](Match& _) {
             return Symbol << (SymbolId ^ _(GlobalId)) << _(Lhs)
                           << (_(Rhs) || (String ^ "")) << (_(Vararg) || None)
-                          << symbolparams(_[Params]) << _(Type);
+                          << (_(Blocking) || None) << symbolparams(_[Params])
+                          << _(Type);
           },
 
         // Type alias.
@@ -537,6 +539,13 @@ namespace vbcc
                        << callargs(_[Args]);
           },
 
+        // Vectored FFI call.
+        Dst * T(FFIMany) * T(GlobalId)[GlobalId] * CallArgs[Args] >>
+          [](Match& _) {
+            return FFIMany << _(LocalId) << (SymbolId ^ _(GlobalId))
+                           << callargs(_[Args]);
+          },
+
         // Static When.
         Dst * T(When) * T(GlobalId)[GlobalId] * CallArgs[Args] * T(Colon) *
             TypePat[Type] >>
@@ -597,7 +597,8 @@ namespace vbcc
         return {};
       };
 
-      // Resolve type of an FFI return from the symbol table.
+      // Resolve type of an FFI return from the symbol table. A blocking call
+      // returns a cown that will hold the result.
       auto get_ffi_return_type = [&](const Node& symbol_id) -> Node {
         for (auto& child : *top)
         {
@@ -606,8 +607,13 @@ namespace vbcc
 
           for (auto& sym : *(child / Symbols))
           {
-            if ((sym / SymbolId)->location() == symbol_id->location())
-              return sym / Return;
+            if ((sym / SymbolId)->location() != symbol_id->location())
+              continue;
+
+            if ((sym / Blocking) == Blocking)
+              return Cown << clone(sym / Return);
+
+            return sym / Return;
           }
         }
 
@@ -1767,7 +1773,7 @@ namespace vbcc
           // These produce None.
           set_type(env, node / LocalId, None);
         }
-        else if (node->type().in({ArrayCopy, ArrayFill}))
+        else if (node->type().in({ArrayCopy, ArrayFill, FFIMany}))
         {
           // Bulk array ops that return None.
           set_type(env, node / LocalId, None);
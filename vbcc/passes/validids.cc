@@ -111,6 +111,59 @@ namespace vbcc
           return NoChange;
         },
 
+        T(Symbol)[Symbol] >> [state](Match& _) -> Node {
+          auto symbol = _(Symbol);
+
+          if ((symbol / Blocking) != Blocking)
+            return NoChange;
+
+          // A blocking call runs on another thread, so it can only take and
+          // return values that don't belong to a region.
+          auto scalar = [](Node t) {
+            return t->in(
+              {Bool,
+               I8,
+               I16,
+               I32,
+               I64,
+               U8,
+               U16,
+               U32,
+               U64,
+               ILong,
+               ULong,
+               ISize,
+               USize,
+               F32,
+               F64,
+               Ptr});
+          };
+
+          if ((symbol / Vararg) == Vararg)
+          {
+            state->error = true;
+            return err(symbol / SymbolId, "blocking symbols can't be varargs");
+          }
+
+          for (auto& param : *(symbol / FFIParams))
+          {
+            if (!scalar(param))
+            {
+              state->error = true;
+              return err(param, "blocking symbol parameters must be scalars");
+            }
+          }
+
+          if (!scalar(symbol / Return) && ((symbol / Return) != None))
+          {
+            state->error = true;
+            return err(
+              symbol / Return, "blocking symbols must return a scalar or none");
+          }
+
+          return NoChange;
+        },
+
         T(GlobalId)[GlobalId] >> [state](Match& /*_*/) -> Node {
           // auto id = state->get_global_id(_(GlobalId));
 
@@ -177,6 +230,38 @@ namespace vbcc
           return NoChange;
         },
 
+        T(FFIMany)[FFIMany] >> [state](Match& _) -> Node {
+          auto ffi = _(FFIMany);
+          auto id = state->get_symbol_id(ffi / SymbolId);
+
+          if (!id)
+            return NoChange;
+
+          // The output array, then one array for each parameter.
+          auto args = ffi / Args;
+          auto symbol = state->symbols.at(*id);
+
+          if ((symbol / Vararg) == Vararg)
+          {
+            state->error = true;
+            return err(ffi / SymbolId, "can't vectorize a varargs symbol");
+          }
+
+          if ((symbol / Blocking) == Blocking)
+          {
+            state->error = true;
+            return err(ffi / SymbolId, "can't vectorize a blocking symbol");
+          }
+
+          if (args->size() != ((symbol / FFIParams)->size() + 1))
+          {
+            state->error = true;
+            return err(args, "wrong number of arguments");
+          }
+
+          return NoChange;
+        },
+
         T(New, Stack, Heap, Region)[New] >> [state](Match& _) -> Node {
           auto alloc = _(New);
           auto id = state->get_class_id(alloc / ClassId);
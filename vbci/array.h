@@ -98,6 +98,17 @@ namespace vbci
       return value_type <= ValueType::Ptr;
     }
 
+    ValueType content_value_type() const
+    {
+      return value_type;
+    }
+
+    // The address of an element, for native code to read or write.
+    void* element_pointer(size_t idx)
+    {
+      return reinterpret_cast<uint8_t*>(this + 1) + (stride * idx);
+    }
+
     void bulk_copy(size_t dst_off, Array* src, size_t src_off, size_t len)
     {
       if (len == 0)
@@ -246,6 +257,17 @@ namespace vbci
       }
     }
 
+    static bool needs_finalize(ValueType t)
+    {
+      return (t == ValueType::Object) || (t == ValueType::Array) ||
+        (t == ValueType::Invalid);
+    }
+
+    bool needs_finalize() const
+    {
+      return needs_finalize(value_type);
+    }
+
     void finalize()
     {
       switch (value_type)
@@ -0,0 +1,102 @@
+#include "blocking.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vbci
+{
+  struct BlockingQueue
+  {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::pair<BlockingPool::Task, void*>> tasks;
+    std::vector<std::thread> threads;
+    size_t num_threads = 4;
+    bool stopping = false;
+
+    ~BlockingQueue()
+    {
+      stop();
+    }
+
+    void push(BlockingPool::Task task, void* arg)
+    {
+      {
+        std::lock_guard lock(mutex);
+
+        if (threads.empty())
+        {
+          stopping = false;
+
+          for (size_t i = 0; i < num_threads; i++)
+            threads.emplace_back([this]() { run(); });
+        }
+
+        tasks.emplace_back(task, arg);
+      }
+
+      cv.notify_one();
+    }
+
+    void stop()
+    {
+      std::vector<std::thread> stopped;
+
+      {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        stopped.swap(threads);
+      }
+
+      cv.notify_all();
+
+      for (auto& t : stopped)
+        t.join();
+    }
+
+  private:
+    void run()
+    {
+      std::unique_lock lock(mutex);
+
+      while (true)
+      {
+        cv.wait(lock, [this]() { return !tasks.empty() || stopping; });
+
+        // Drain the queue before stopping.
+        if (tasks.empty())
+          return;
+
+        auto [task, arg] = tasks.front();
+        tasks.pop_front();
+        lock.unlock();
+        task(arg);
+        lock.lock();
+      }
+    }
+  };
+
+  static BlockingQueue blocking_queue;
+
+  void BlockingPool::set_threads(size_t num_threads)
+  {
+    assert(num_threads > 0);
+    std::lock_guard lock(blocking_queue.mutex);
+    blocking_queue.num_threads = num_threads;
+  }
+
+  void BlockingPool::submit(Task task, void* arg)
+  {
+    blocking_queue.push(task, arg);
+  }
+
+  void BlockingPool::stop()
+  {
+    blocking_queue.stop();
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace vbci
+{
+  // A pool of threads for FFI calls to symbols marked blocking, so that a call
+  // that waits doesn't hold a scheduler thread.
+  struct BlockingPool
+  {
+    using Task = void (*)(void* arg);
+
+    // There must be at least one thread.
+    static void set_threads(size_t num_threads);
+
+    // Runs the task on a pool thread. The pool starts on first use.
+    static void submit(Task task, void* arg);
+
+    // Waits for every submitted task to finish, and stops the pool.
+    static void stop();
+  };
+}
@@ -5,8 +5,15 @@
 #include "thread.h"
 #include "value.h"
 
+#include <atomic>
+
 namespace vbci
 {
+  static std::atomic<size_t> num_callbacks{0};
+  static std::atomic<size_t> num_prechecked{0};
+  static std::atomic<uint64_t> callback_ns{0};
+  static std::atomic<uint64_t> max_callback_ns{0};
+
   // Universal libffi trampoline. Called by C code through the closure's
   // code_ptr. Marshals C arguments back to Verona Values and calls the
   // lambda's apply method via Thread::handle_callback.
@@ -34,7 +41,11 @@ namespace vbci
     // Build the ffi_cif from the apply function's signature.
     // func->param_types[0] is self (the lambda), skip it.
     // func->param_types[1:] are the actual callback parameters.
+    // A C argument that isn't passed as a Value always has the primitive type
+    // it was laid out as, so it only needs to be checked once, here.
     auto& program = Program::get();
+    cc->prechecked = !func->param_types.empty() &&
+      program.subtype(lambda->type_id(), func->param_types[0]);
 
     for (size_t i = 1; i < func->param_types.size(); i++)
     {
@@ -42,9 +53,15 @@ namespace vbci
       cc->arg_value_types.push_back(rep.first);
 
       if (rep.first == ValueType::Invalid)
+      {
         cc->arg_ffi_types.push_back(program.value_type());
+        cc->prechecked = false;
+      }
       else
+      {
         cc->arg_ffi_types.push_back(rep.second);
+        cc->prechecked &= program.subtype(+rep.first, func->param_types[i]);
+      }
     }
 
     // Return type.
@@ -83,4 +100,29 @@ namespace vbci
     cc->lambda = lambda.borrow();
     return cc;
   }
+
+  void record_callback(bool prechecked, uint64_t ns)
+  {
+    num_callbacks.fetch_add(1, std::memory_order_relaxed);
+
+    if (prechecked)
+      num_prechecked.fetch_add(1, std::memory_order_relaxed);
+
+    callback_ns.fetch_add(ns, std::memory_order_relaxed);
+    auto max = max_callback_ns.load(std::memory_order_relaxed);
+
+    while ((ns > max) &&
+           !max_callback_ns.compare_exchange_weak(
+             max, ns, std::memory_order_relaxed))
+    {}
+  }
+
+  CallbackStats callback_stats()
+  {
+    return {
+      num_callbacks.load(std::memory_order_relaxed),
+      num_prechecked.load(std::memory_order_relaxed),
+      callback_ns.load(std::memory_order_relaxed),
+      max_callback_ns.load(std::memory_order_relaxed)};
+  }
 }
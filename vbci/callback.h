@@ -4,11 +4,20 @@
 #include "location.h"
 #include "register.h"
 
+#include <cstdint>
 #include <ffi.h>
 #include <vector>
 
 namespace vbci
 {
+  struct CallbackStats
+  {
+    size_t calls;
+    size_t prechecked;
+    uint64_t total_ns;
+    uint64_t max_ns;
+  };
+
   struct CallbackClosure
   {
     ffi_closure* closure;
@@ -23,6 +32,10 @@ namespace vbci
     // owns the callable and is responsible for freeing this closure before the
     // callable goes away.
     Value lambda;
+    // True if the lambda and every C argument were known to match the apply
+    // function's parameter types when the closure was made, so calls don't
+    // check them again.
+    bool prechecked;
 
     // Free a callback closure. The borrowed lambda is owned by the enclosing
     // Verona callback object.
@@ -35,4 +48,10 @@ namespace vbci
 
   // Create a callback closure from a lambda and its apply function.
   CallbackClosure* make_callback(const Register& lambda, Function* func);
+
+  // Records a completed callback. Only called while stats are being reported.
+  void record_callback(bool prechecked, uint64_t ns);
+
+  // Counts and timings for every callback so far, across all threads.
+  CallbackStats callback_stats();
 }
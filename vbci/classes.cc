@@ -24,6 +24,19 @@ namespace vbci
       auto rep = program.layout_type_id(f.type_id);
       f.value_type = rep.first;
       ffi_types.push_back(rep.second);
+
+      switch (f.value_type)
+      {
+        case ValueType::Object:
+        case ValueType::Array:
+        case ValueType::Invalid:
+        case ValueType::Cown:
+          has_refs = true;
+          break;
+
+        default:
+          break;
+      }
     }
 
     ffi_types.push_back(nullptr);
@@ -55,16 +68,12 @@ namespace vbci
 
   Function* Class::finalizer()
   {
-    return method(FinalMethodId);
+    return final_fn;
   }
 
   Function* Class::method(size_t w)
   {
-    auto find = methods.find(w);
-    if (find == methods.end())
-      return nullptr;
-
-    return find->second;
+    return Program::get().method(*this, w);
   }
 
   Class::~Class()
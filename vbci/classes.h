@@ -4,7 +4,7 @@
 #include "value.h"
 
 #include <ffi.h>
-#include <unordered_map>
+#include <utility>
 #include <vbci.h>
 #include <vector>
 
@@ -42,12 +42,26 @@ namespace vbci
     Class(Class&&) = default;
     Class& operator=(Class&&) = default;
 
-    // Precalculate an offset into the object for each field name.
-    std::unordered_map<size_t, size_t> field_map;
+    // The field index for each field name, sorted by name. Lookups go
+    // through the program's field table, at field_offset.
+    std::vector<std::pair<size_t, size_t>> field_map;
     std::vector<Field> fields;
+    size_t field_offset = 0;
 
-    // Precalculate a function pointer for each method name.
-    std::unordered_map<size_t, Function*> methods;
+    // The function pointer for each method name, sorted by name. Lookups go
+    // through the program's method table, at method_offset.
+    std::vector<std::pair<size_t, Function*>> methods;
+    size_t method_offset = 0;
+
+    // Found at load time, so that objects with no finalizer and no reference
+    // fields can be collected without finalizing them.
+    Function* final_fn = nullptr;
+    bool has_refs = false;
+
+    bool needs_finalize() const
+    {
+      return final_fn || has_refs;
+    }
 
     bool calc_size();
     Function* finalizer();
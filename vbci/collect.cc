@@ -17,6 +17,8 @@
 #include "header.h"
 #include "object.h"
 #include "region.h"
+#include "reclaim.h"
+#include "region_arena.h"
 
 #include <queue>
 #include <type_traits>
@@ -113,7 +115,7 @@ namespace vbci
 
       if (h->location().is_immutable() || h->location().is_pending())
       {
-        delete[] reinterpret_cast<uint8_t*>(h);
+        free_header(h);
       }
       else
       {
@@ -124,7 +126,9 @@ namespace vbci
     for (auto* r : regions_to_delete)
     {
       LOG(Trace) << "Deleting work item: " << static_cast<void*>(r);
-      r->release_dead_objects();
+
+      if (!Reclaimer::defer(r))
+        r->release_dead_objects();
     }
 
     headers_to_delete.clear();
@@ -170,9 +174,31 @@ namespace vbci
       drain_work_list();
   }
 
+  bool needs_finalize(Header* h)
+  {
+    if (Program::get().is_array(h->get_type_id()))
+      return static_cast<Array*>(h)->needs_finalize();
+
+    return static_cast<Object*>(h)->cls().needs_finalize();
+  }
+
   template void collect<Header>(Header* h);
   template void collect<Region>(Region* h);
 
+  void collect_garbage(const std::vector<Header*>& garbage)
+  {
+    // Detach every header first. When finalizing one header drops the RC of
+    // another to zero, the collector then skips it, as it is already queued.
+    for (auto h : garbage)
+    {
+      h->region()->remove(h);
+      worklist.emplace(Tag<Header>::value, h);
+    }
+
+    if (!in_collection)
+      drain_work_list();
+  }
+
   // Collect a frozen SCC: walk all members via SCC_PTR chains,
   // mark each as pending (processing sentinel), and push onto the
   // collector worklist. The two-phase collector handles finalization
@@ -1,5 +1,7 @@
 // Delay deallocation to handle re-entrancy.
 
+#include <vector>
+
 namespace vbci
 {
   struct Header;
@@ -10,4 +12,10 @@ namespace vbci
   // Collect a frozen SCC: find all members and push them onto the
   // collector worklist so finalizers run before memory is freed.
   void collect_scc(Header* root);
+
+  // Returns true if the header has a finalizer or holds references.
+  bool needs_finalize(Header* h);
+
+  // Collect unreachable headers in a region, which may reference each other.
+  void collect_garbage(const std::vector<Header*>& garbage);
 } // namespace vbci
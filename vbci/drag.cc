@@ -7,43 +7,86 @@
 
 namespace vbci
 {
+  // Scratch space reused by every drag on a thread. Dragged headers are
+  // marked by making their location pending, and sub-regions record their
+  // entry point, so a drag needs no lookup tables.
+  struct DragState
+  {
+    std::vector<Header*> wl;
+    std::vector<Header*> dragged;
+    std::vector<Region*> regions;
+    bool busy = false;
+
+    void clear()
+    {
+      wl.clear();
+      dragged.clear();
+      regions.clear();
+    }
+
+    // Undo every mark if the drag fails.
+    bool fail()
+    {
+      for (auto hh : dragged)
+        hh->set_location(hh->location().unpending());
+
+      for (auto hr : regions)
+        hr->take_drag_entry();
+
+      clear();
+      return false;
+    }
+  };
+
+  static thread_local DragState drag_state;
+
   template<bool is_move>
   bool drag_allocation(Region* r, Header* h, Region** pr)
   {
+    DeferredStackRC::reconcile();
     bool frame_local = r->is_frame_local();
     auto& program = Program::get();
     size_t stack_rc_decs = 0;
 
-    std::vector<Header*> wl;
-    std::unordered_map<Header*, RC> rc_map;
-    std::unordered_map<Region*, Header*> regions;
-    wl.push_back(h);
+    // A drag can free a region, which runs finalizers that can drag again.
+    // Only the outermost drag uses the thread's scratch space.
+    DragState nested;
+    auto& s = drag_state.busy ? nested : drag_state;
+    s.busy = true;
+
+    // Every visit to a dragged header is a reference from inside the dragged
+    // graph, except the reference from the caller's register.
+    RC internal = 0;
+    s.wl.push_back(h);
 
     auto fn = [&](Header* h) {
       // Only add mutable, heap allocated objects and arrays to the list.
-      if (h->location().is_region())
-        wl.push_back(h);
+      auto loc = h->location();
+
+      if (loc.is_region() || loc.is_pending())
+        s.wl.push_back(h);
     };
 
-    while (!wl.empty())
+    while (!s.wl.empty())
     {
-      Header* next_h = wl.back();
-      wl.pop_back();
+      Header* next_h = s.wl.back();
+      s.wl.pop_back();
+      auto loc = next_h->location();
 
-      auto find = rc_map.find(next_h);
-      if (find != rc_map.end())
+      if (loc.is_pending())
       {
-        find->second++;
+        internal++;
         continue;
       }
 
-      auto loc = next_h->location();
-
       if (loc.is_immutable())
         continue;
 
       if (loc.is_stack())
-        return false;
+      {
+        s.busy = false;
+        return s.fail();
+      }
 
       assert(loc.is_region());
       auto hr = loc.to_region();
@@ -81,21 +124,24 @@ namespace vbci
           if (hr->has_parent() && (hr->get_parent() == r))
             continue;
 
-          if (hr->has_owner())
-            return false;
-
-          if (hr->is_ancestor_of(r))
-            return false;
+          if (
+            hr->has_owner() || hr->is_ancestor_of(r) ||
+            !hr->mark_drag_entry(next_h))
+          {
+            s.busy = false;
+            return s.fail();
+          }
 
-          if (!regions.emplace(hr, next_h).second)
-            return false;
+          s.regions.push_back(hr);
         }
 
         continue;
       }
 
       // Object is in a frame-local region — drag it to the destination.
-      rc_map[next_h] = 1;
+      internal++;
+      next_h->set_location(loc.pending());
+      s.dragged.push_back(next_h);
 
       if (program.is_array(next_h->get_type_id()))
         static_cast<Array*>(next_h)->trace_fn(fn);
@@ -110,33 +156,38 @@ namespace vbci
     r->stack_inc();
 
     // Parent tracked sub-regions to the destination.
-    for (auto& [hr, entry] : regions)
+    for (auto hr : s.regions)
     {
-      hr->set_parent(r, entry);
+      hr->set_parent(r, hr->take_drag_entry());
       hr->stack_dec();
     }
 
-    // Move objects to the new region.
-    for (auto& [hh, rc] : rc_map)
-    {
-      LOG(Trace) << "Dragging header @" << hh << " to region @" << r
-                 << " with internal rc " << rc;
+    // Move objects to the new region. References from outside the dragged
+    // graph become stack RCs of the destination.
+    RC total = 0;
 
-      if (hh == h)
-      {
-        if constexpr (!is_move)
-          rc--;
-      }
+    if (!s.dragged.empty() && (s.dragged.front() == h))
+    {
+      if constexpr (!is_move)
+        internal--;
+    }
 
-      assert(hh->get_rc() >= rc);
-      r->stack_inc(hh->get_rc() - rc);
+    for (auto hh : s.dragged)
+    {
+      LOG(Trace) << "Dragging header @" << hh << " to region @" << r;
+      total += hh->get_rc();
+      hh->set_location(hh->location().unpending());
       hh->move_region(r);
     }
 
+    assert(total >= internal);
+    r->stack_inc(total - internal);
     r->stack_dec(stack_rc_decs);
 
     // Release the guard.
     r->stack_dec();
+    s.clear();
+    s.busy = false;
     return true;
   }
 
@@ -3,9 +3,145 @@
 #include "program.h"
 #include "value.h"
 
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
 namespace vbci
 {
-  Symbol::Symbol(Func func, bool vararg) : func(func), vararg(vararg) {}
+  // Returns true if a value of this type is passed and returned in an integer
+  // register, so that a thunk can call a function that uses it.
+  static bool is_word(ValueType t)
+  {
+    switch (t)
+    {
+      case ValueType::Bool:
+      case ValueType::I8:
+      case ValueType::I16:
+      case ValueType::I32:
+      case ValueType::I64:
+      case ValueType::U8:
+      case ValueType::U16:
+      case ValueType::U32:
+      case ValueType::U64:
+      case ValueType::ILong:
+      case ValueType::ULong:
+      case ValueType::ISize:
+      case ValueType::USize:
+      case ValueType::Ptr:
+      case ValueType::Object:
+      case ValueType::Array:
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  // Load an argument as a word, extended as libffi would.
+  static uint64_t load_word(ValueType t, const void* p)
+  {
+    switch (t)
+    {
+      case ValueType::Bool:
+        return *static_cast<const bool*>(p);
+      case ValueType::I8:
+        return uint64_t(*static_cast<const int8_t*>(p));
+      case ValueType::I16:
+        return uint64_t(*static_cast<const int16_t*>(p));
+      case ValueType::I32:
+        return uint64_t(*static_cast<const int32_t*>(p));
+      case ValueType::I64:
+        return uint64_t(*static_cast<const int64_t*>(p));
+      case ValueType::U8:
+        return *static_cast<const uint8_t*>(p);
+      case ValueType::U16:
+        return *static_cast<const uint16_t*>(p);
+      case ValueType::U32:
+        return *static_cast<const uint32_t*>(p);
+      case ValueType::U64:
+        return *static_cast<const uint64_t*>(p);
+      case ValueType::ILong:
+        return uint64_t(*static_cast<const long*>(p));
+      case ValueType::ULong:
+        return *static_cast<const unsigned long*>(p);
+      case ValueType::ISize:
+        return uint64_t(*static_cast<const ssize_t*>(p));
+      case ValueType::USize:
+        return *static_cast<const size_t*>(p);
+      default:
+        return uintptr_t(*static_cast<void* const*>(p));
+    }
+  }
+
+  // Only the low bits of a narrow return value are defined. Extend them as
+  // libffi would.
+  static uint64_t widen(ValueType t, uint64_t r)
+  {
+    switch (t)
+    {
+      case ValueType::None:
+        return 0;
+      case ValueType::Bool:
+        return uint8_t(r) != 0;
+      case ValueType::I8:
+        return uint64_t(int8_t(r));
+      case ValueType::I16:
+        return uint64_t(int16_t(r));
+      case ValueType::I32:
+        return uint64_t(int32_t(r));
+      case ValueType::U8:
+        return uint8_t(r);
+      case ValueType::U16:
+        return uint16_t(r);
+      case ValueType::U32:
+        return uint32_t(r);
+      case ValueType::ILong:
+        return uint64_t(long(r));
+      case ValueType::ULong:
+        return static_cast<unsigned long>(r);
+      default:
+        return r;
+    }
+  }
+
+  template<size_t N, bool Void>
+  static uint64_t thunk(Symbol::Func func, const uint64_t* words)
+  {
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+      if constexpr (Void)
+      {
+        reinterpret_cast<void (*)(decltype(I, uint64_t())...)>(func)(
+          words[I]...);
+        return uint64_t(0);
+      }
+      else
+      {
+        return reinterpret_cast<uint64_t (*)(decltype(I, uint64_t())...)>(
+          func)(words[I]...);
+      }
+    }(std::make_index_sequence<N>());
+  }
+
+  template<bool Void>
+  static constexpr Symbol::Thunk thunks[Symbol::MaxThunkArgs + 1] = {
+    thunk<0, Void>,
+    thunk<1, Void>,
+    thunk<2, Void>,
+    thunk<3, Void>,
+    thunk<4, Void>,
+    thunk<5, Void>,
+    thunk<6, Void>,
+  };
+
+  Symbol::Symbol(Func func, bool vararg)
+  : func(func),
+    thunk(nullptr),
+    vararg(vararg),
+    blocking(false),
+    blocking_cown_type(DynId),
+    var_cifs_mutex(vararg ? std::make_unique<std::shared_mutex>() : nullptr)
+  {}
 
   void Symbol::param(uint32_t type_id)
   {
@@ -17,6 +153,12 @@ namespace vbci
     return_type = type_id;
   }
 
+  void Symbol::set_blocking(uint32_t cown_type_id)
+  {
+    blocking = true;
+    blocking_cown_type = cown_type_id;
+  }
+
   bool Symbol::prepare()
   {
     if (!func)
@@ -38,9 +180,45 @@ namespace vbci
     if (return_value_type == ValueType::Invalid)
       return_ffi_type = program.value_type();
 
+    if (blocking)
+    {
+      // A blocking call runs on another thread, so its arguments and result
+      // can't belong to a region.
+      if (
+        vararg || (return_value_type > ValueType::Ptr) ||
+        !program.is_cown(blocking_cown_type))
+        return false;
+
+      for (auto t : param_value_types)
+      {
+        if ((t == ValueType::None) || (t > ValueType::Ptr))
+          return false;
+      }
+    }
+
     if (vararg)
       return true;
 
+    // A call that only passes and returns integer words can skip libffi, on
+    // platforms where a word is a register and every integer fits in one.
+    bool words = (sizeof(void*) == sizeof(uint64_t)) &&
+      (sizeof(long) <= sizeof(uint64_t)) &&
+      (param_value_types.size() <= MaxThunkArgs) &&
+      ((return_value_type == ValueType::None) ||
+       (is_word(return_value_type) &&
+        (return_value_type != ValueType::Object) &&
+        (return_value_type != ValueType::Array)));
+
+    for (auto t : param_value_types)
+      words = words && is_word(t);
+
+    if (words)
+    {
+      auto n = param_value_types.size();
+      thunk = (return_value_type == ValueType::None) ? thunks<true>[n] :
+                                                       thunks<false>[n];
+    }
+
     return ffi_prep_cif(
              &cif,
              FFI_DEFAULT_ABI,
@@ -54,6 +232,16 @@ namespace vbci
     return vararg;
   }
 
+  bool Symbol::is_blocking()
+  {
+    return blocking;
+  }
+
+  uint32_t Symbol::blocking_cown()
+  {
+    return blocking_cown_type;
+  }
+
   std::vector<uint32_t>& Symbol::params()
   {
     return param_types;
@@ -74,34 +262,76 @@ namespace vbci
     return return_value_type;
   }
 
-  void Symbol::varparam(ffi_type* ffit)
+  Value Symbol::call(std::vector<const void*>& args)
   {
-    if (!vararg)
-      Value::error(Error::BadArgs);
-
-    param_ffi_types.push_back(ffit);
+    static const std::vector<ffi_type*> no_var_types;
+    return call(args, no_var_types);
   }
 
-  Value Symbol::call(std::vector<const void*>& args)
+  Value Symbol::call(
+    std::vector<const void*>& args, const std::vector<ffi_type*>& var_types)
   {
     if (!func)
       Value::error(Error::UnknownFFI);
 
+    if (thunk)
+    {
+      uint64_t words[MaxThunkArgs];
+
+      for (size_t i = 0; i < param_value_types.size(); i++)
+        words[i] = load_word(param_value_types[i], args[i]);
+
+      return Value::from_ffi(
+        return_value_type, widen(return_value_type, thunk(func, words)));
+    }
+
+    auto call_cif = &cif;
+
+    if (!var_types.empty() && !vararg)
+      Value::error(Error::BadArgs);
+
     if (vararg)
     {
-      if (args.size() != param_ffi_types.size())
+      // The key is built in a buffer owned by the calling thread.
+      static thread_local std::vector<ffi_type*> types;
+      types.assign(param_ffi_types.begin(), param_ffi_types.end());
+      types.insert(types.end(), var_types.begin(), var_types.end());
+
+      if (args.size() < types.size())
         Value::error(Error::BadArgs);
 
-      if (
-        ffi_prep_cif_var(
-          &cif,
-          FFI_DEFAULT_ABI,
-          static_cast<unsigned>(param_types.size()),
-          static_cast<unsigned>(args.size()),
-          return_ffi_type,
-          param_ffi_types.data()) != FFI_OK)
+      // Preparing a varargs CIF is costly, so reuse one prepared for the same
+      // argument types.
+      call_cif = nullptr;
+
       {
-        Value::error(Error::BadArgs);
+        std::shared_lock lock(*var_cifs_mutex);
+        auto it = var_cifs.find(types);
+
+        if (it != var_cifs.end())
+          call_cif = &it->second;
+      }
+
+      if (!call_cif)
+      {
+        std::unique_lock lock(*var_cifs_mutex);
+        auto [it, inserted] = var_cifs.try_emplace(types);
+
+        if (
+          inserted &&
+          (ffi_prep_cif_var(
+             &it->second,
+             FFI_DEFAULT_ABI,
+             static_cast<unsigned>(param_types.size()),
+             static_cast<unsigned>(types.size()),
+             return_ffi_type,
+             const_cast<ffi_type**>(it->first.data())) != FFI_OK))
+        {
+          var_cifs.erase(it);
+          Value::error(Error::BadArgs);
+        }
+
+        call_cif = &it->second;
       }
     }
 
@@ -113,20 +343,17 @@ namespace vbci
     {
       // Expect the ffi call to not modify the args in place.
       // Hence, the const_cast.
-      ffi_call(&cif, func, &ret, const_cast<void**>(args.data()));
+      ffi_call(call_cif, func, &ret, const_cast<void**>(args.data()));
     }
     else
     {
       ffi_arg r = 0;
       // Expect the ffi call to not modify the args in place.
       // Hence, the const_cast.
-      ffi_call(&cif, func, &r, const_cast<void**>(args.data()));
+      ffi_call(call_cif, func, &r, const_cast<void**>(args.data()));
       ret = Value::from_ffi(return_value_type, r);
     }
 
-    if (vararg)
-      param_ffi_types.resize(param_types.size());
-
     return ret;
   }
 
@@ -5,6 +5,9 @@
 
 #include <ffi.h>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -25,11 +28,32 @@ namespace vbci
   {
     using Func = void (*)();
 
+    // Calls a function whose arguments are all passed as integer words,
+    // without libffi.
+    using Thunk = uint64_t (*)(Func func, const uint64_t* words);
+    static constexpr size_t MaxThunkArgs = 6;
+
   private:
     ffi_cif cif;
     Func func;
+    Thunk thunk;
     bool vararg;
 
+    // Calls to a blocking symbol return a cown of this type, which holds the
+    // result once the call returns.
+    bool blocking;
+    uint32_t blocking_cown_type;
+
+    // Varargs CIFs, by the types of all arguments. Each CIF points into its
+    // key for the argument types. Entries are never removed once prepared, so
+    // a CIF found under the shared lock stays valid.
+    std::map<std::vector<ffi_type*>, ffi_cif> var_cifs;
+
+    // Guards var_cifs, as a symbol can be called from any thread. Lookups
+    // share the lock, and only preparing a new CIF takes it alone. It's held
+    // by pointer so that symbols can be moved into the program's table.
+    std::unique_ptr<std::shared_mutex> var_cifs_mutex;
+
     std::vector<uint32_t> param_types;
     std::vector<ValueType> param_value_types;
     uint32_t return_type;
@@ -43,16 +67,23 @@ namespace vbci
 
     void param(uint32_t type_id);
     void ret(uint32_t type_id);
+    void set_blocking(uint32_t cown_type_id);
     bool prepare();
 
     bool varargs();
+    bool is_blocking();
+    uint32_t blocking_cown();
     std::vector<uint32_t>& params();
     std::vector<ValueType>& paramvals();
     uint32_t ret();
     ValueType retval();
 
-    void varparam(ffi_type* ffit);
     Value call(std::vector<const void*>& args);
+
+    // Calls a varargs symbol. The types of the arguments past the fixed
+    // parameters are given by the caller.
+    Value call(
+      std::vector<const void*>& args, const std::vector<ffi_type*>& var_types);
     void* raw_pointer();
   };
 
@@ -10,7 +10,7 @@ namespace vbci
     Function* func,
     Location frame_id,
     Stack::Idx save,
-    std::vector<Register>& locals,
+    RegisterFile& locals,
     size_t base,
     std::vector<Object*>& finalize,
     size_t finalize_base,
@@ -35,22 +35,13 @@ namespace vbci
   {
     assert(idx < func->registers && "Local index out of bounds");
 
-    auto i = base + idx;
-
-    while (i >= locals.size())
-      locals.resize(locals.size() * 2);
-
-    return locals.at(i);
+    // Pushing the frame made room for every register.
+    return locals[base + idx];
   }
 
   Register& Frame::arg(size_t idx)
   {
-    auto i = base + func->registers + idx;
-
-    while (i >= locals.size())
-      locals.resize(locals.size() * 2);
-
-    return locals.at(i);
+    return locals.at(base + func->registers + idx);
   }
 
   std::span<Register> Frame::args(size_t args)
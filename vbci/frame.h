@@ -1,7 +1,7 @@
 #pragma once
 
 #include "region.h"
-#include "register.h"
+#include "register_file.h"
 #include "stack.h"
 #include "value.h"
 
@@ -16,7 +16,7 @@ namespace vbci
     Function* func;
     Location frame_id;
     Stack::Idx save;
-    std::vector<Register>& locals;
+    RegisterFile& locals;
     size_t base;
     std::vector<Object*>& finalize;
     size_t finalize_base;
@@ -29,7 +29,7 @@ namespace vbci
       Function* func,
       Location frame_id,
       Stack::Idx save,
-      std::vector<Register>& locals,
+      RegisterFile& locals,
       size_t base,
       std::vector<Object*>& finalize,
       size_t finalize_base,
@@ -6,11 +6,17 @@
 #include "program.h"
 #include "region_ext.h"
 
-#include <unordered_set>
+#include <atomic>
+#include <chrono>
 #include <vector>
 
 namespace vbci
 {
+  static std::atomic<size_t> num_freezes{0};
+  static std::atomic<size_t> num_frozen{0};
+  static std::atomic<uint64_t> freeze_ns{0};
+  static std::atomic<uint64_t> max_freeze_ns{0};
+
   // Post-order marker: set LSB of pointer.
   static Header* post_order_mark(Header* h)
   {
@@ -46,13 +52,23 @@ namespace vbci
     r->set_location(Location::scc_ptr(rep_r));
   }
 
+  // Returns true if the header was frozen by the current pass over a region.
+  // Those SCC representatives are stamped with a location unique to the pass.
+  static bool frozen_by(Header* h, Location stamp)
+  {
+    if (h->location().is_scc_ptr())
+      h = Header::find(h);
+
+    return h->location() == stamp;
+  }
+
   // Trace a header's fields, pushing children onto the DFS stack.
   // Returns the number of frozen-to-frozen edges found.
   static RC trace_fields(
     Header* h,
     std::vector<Header*>& dfs,
     Region* region = nullptr,
-    std::unordered_set<Header*>* frozen_set = nullptr)
+    const Location* stamp = nullptr)
   {
     RC frozen_edges = 0;
     auto& program = Program::get();
@@ -70,7 +86,7 @@ namespace vbci
       if (loc.is_immutable() || loc.is_immortal())
       {
         // Count edges to objects frozen by THIS call.
-        if (frozen_set && frozen_set->count(h))
+        if (stamp && (loc == *stamp))
           frozen_edges++;
         return;
       }
@@ -92,7 +108,9 @@ namespace vbci
     return frozen_edges;
   }
 
-  void freeze_local(Header* root)
+  static void freeze_region(Header* root, size_t& objects);
+
+  static void freeze_local(Header* root, size_t& objects)
   {
     assert(root);
     assert(root->location().is_region());
@@ -158,6 +176,7 @@ namespace vbci
         obj_region->remove(h);
 
         h->set_location(Location::from_raw(Location::Pending));
+        objects++;
 
         pending.push_back(h);
         dfs.push_back(post_order_mark(h));
@@ -168,35 +187,26 @@ namespace vbci
     }
 
     // Phase 2: freeze any heap-region objects discovered during the
-    // frame-local DFS. Duplicates and already-frozen objects are handled
-    // by freeze() (immutable check returns true early).
+    // frame-local DFS. Duplicates and already-frozen objects are skipped.
     for (auto h : heap_roots)
-      freeze(h);
-  }
-
-  bool freeze(Header* root)
-  {
-    assert(root);
-    auto loc = root->location();
-
-    if (loc.is_immutable() || loc.is_immortal())
-      return true;
-
-    if (loc.is_stack())
-      return false;
-
-    auto region = loc.to_region();
-
-    if (region->is_frame_local())
     {
-      freeze_local(root);
-      return true;
+      if (!h->location().is_immutable())
+        freeze_region(h, objects);
     }
+  }
 
+  static void freeze_region(Header* root, size_t& objects)
+  {
     std::vector<Header*> worklist;
     std::vector<Header*> dfs;
     std::vector<Header*> pending;
-    std::unordered_set<Header*> frozen_set;
+    std::vector<Header*> frozen;
+
+    // Objects frozen by a pass over one region are recognised by their
+    // representative's location, which is stamped with an address unique to
+    // this call. The stamps are cleared when the pass is done.
+    auto stamp = Location::from_raw(
+      Location::Immutable | reinterpret_cast<uintptr_t>(&frozen));
 
     worklist.push_back(root);
 
@@ -210,12 +220,12 @@ namespace vbci
       if (root->location().is_immutable() || root->location().is_scc_ptr())
         continue;
 
-      region = root->region();
+      auto region = root->region();
       bool is_sub = region->has_owner();
 
       RC arc_sum = 0;
       RC frozen_internal = 0;
-      frozen_set.clear();
+      frozen.clear();
 
       dfs.push_back(root);
 
@@ -233,8 +243,9 @@ namespace vbci
             pending.pop_back();
             auto rep = Header::find(h);
             arc_sum += rep->get_rc();
-            rep->set_location(Location::immutable());
+            rep->set_location(stamp);
             rep->set_arc(rep->get_rc());
+            frozen.push_back(rep);
           }
 
           continue;
@@ -264,11 +275,11 @@ namespace vbci
           {
             region->remove(h);
             h->set_location(Location::from_raw(Location::Pending));
-            frozen_set.insert(h);
+            objects++;
 
             pending.push_back(h);
             dfs.push_back(post_order_mark(h));
-            frozen_internal += trace_fields(h, dfs, region, &frozen_set);
+            frozen_internal += trace_fields(h, dfs, region, &stamp);
           }
           else if (!rep_loc.to_region()->is_frame_local())
           {
@@ -283,7 +294,7 @@ namespace vbci
 
       region->for_each_header([&](Header* h) {
         auto count_fn = [&](Header* target) {
-          if (frozen_set.count(target))
+          if (frozen_by(target, stamp))
             unfrozen_to_frozen++;
         };
 
@@ -293,6 +304,9 @@ namespace vbci
           static_cast<Object*>(h)->trace_fn(count_fn);
       });
 
+      for (auto rep : frozen)
+        rep->set_location(Location::immutable());
+
       // For sub-regions, subtract the frozen parent's field ref to the
       // entry point (not a stack ref).
       RC parent_ref = is_sub ? 1 : 0;
@@ -312,7 +326,63 @@ namespace vbci
       if (stack_adjustment > 0)
         region->stack_dec(stack_adjustment);
     }
+  }
 
+  bool freeze(Header* root)
+  {
+    assert(root);
+    DeferredStackRC::reconcile();
+    auto loc = root->location();
+
+    if (loc.is_immutable() || loc.is_immortal())
+      return true;
+
+    if (loc.is_stack())
+      return false;
+
+    // Only count and time freezes while stats are being reported, as the
+    // clock reads and shared counters would otherwise dominate small freezes.
+    auto timed = logging::Info::active();
+    std::chrono::steady_clock::time_point start;
+
+    if (timed)
+      start = std::chrono::steady_clock::now();
+
+    size_t objects = 0;
+
+    if (loc.to_region()->is_frame_local())
+      freeze_local(root, objects);
+    else
+      freeze_region(root, objects);
+
+    if (!timed)
+      return true;
+
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+    num_freezes.fetch_add(1, std::memory_order_relaxed);
+    num_frozen.fetch_add(objects, std::memory_order_relaxed);
+    freeze_ns.fetch_add(ns, std::memory_order_relaxed);
+
+    auto max = max_freeze_ns.load(std::memory_order_relaxed);
+
+    while ((ns > max) &&
+           !max_freeze_ns.compare_exchange_weak(
+             max, ns, std::memory_order_relaxed))
+    {}
+
+    LOG(Debug) << "Froze " << objects << " objects in " << ns << "ns";
     return true;
   }
+
+  FreezeStats freeze_stats()
+  {
+    return {
+      num_freezes.load(std::memory_order_relaxed),
+      num_frozen.load(std::memory_order_relaxed),
+      freeze_ns.load(std::memory_order_relaxed),
+      max_freeze_ns.load(std::memory_order_relaxed)};
+  }
 }
@@ -1,14 +1,31 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace vbci
 {
   struct Header;
 
+  struct FreezeStats
+  {
+    size_t freezes;
+    size_t objects;
+    uint64_t total_ns;
+    uint64_t max_ns;
+  };
+
   // Freeze the reachable subgraph from root: calculate SCCs, set up
   // union-find for ARC tracking, and make reachable objects immutable.
   // The region survives with unfrozen objects; stack_rc is adjusted.
   // Sub-regions reachable from frozen objects are frozen in the same way.
   // No-op (returns true) if root is already immutable or immortal.
   // Returns false if root is on the stack.
+  // The whole graph is frozen on the calling thread before this returns. It
+  // isn't split into slices or across workers.
   bool freeze(Header* root);
+
+  // Counts and timings for every freeze so far, across all threads. Freezes
+  // are only counted while info logging is on.
+  FreezeStats freeze_stats();
 }
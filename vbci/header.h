@@ -7,17 +7,61 @@
 #include "register.h"
 #include "value.h"
 
-#include <limits>
-
 namespace vbci
 {
-  struct Header
+  struct Header;
+
+  // Reference count changes on frozen SCCs, batched per thread. Many
+  // behaviours reading the same frozen data all contend on its atomic count.
+  // Instead, a decrement is buffered and applied at the next safe point, and
+  // an increment on the same thread cancels it without an atomic operation.
+  // Until then the count over-counts, so the SCC can't be freed early.
+  struct DeferredARC
   {
+  private:
+    static inline bool enabled = false;
+    static inline thread_local DeferredDecs<Header> local;
+
+    static void apply(Header* h, RC count);
+
   public:
-    static constexpr uint32_t StackSentinelTypeId =
-      std::numeric_limits<uint32_t>::max();
+    static void set_enabled(bool value)
+    {
+      enabled = value;
+    }
+
+    // Returns true if the increment cancelled a buffered decrement.
+    static bool cancel(Header* h)
+    {
+      return enabled && local.cancel(h);
+    }
+
+    // Returns true if the decrement was buffered.
+    static bool defer(Header* h)
+    {
+      if (!enabled)
+        return false;
+
+      local.defer(h, apply);
+      return true;
+    }
+
+    static void reconcile()
+    {
+      if (local.size > 0)
+        local.flush(apply);
+    }
+  };
+
+  struct Header
+  {
+    friend struct DeferredARC;
 
   private:
+    // The top bit of the type ID marks an allocation made by an arena, so
+    // freeing it returns it to its chunk.
+    static constexpr uint32_t ArenaBit = uint32_t(1) << 31;
+
     Location loc;
 
     union
@@ -40,7 +84,17 @@ namespace vbci
   public:
     uint32_t get_type_id() const
     {
-      return type_id;
+      return type_id & ~ArenaBit;
+    }
+
+    bool is_arena_alloc() const
+    {
+      return (type_id & ArenaBit) != 0;
+    }
+
+    void mark_arena_alloc()
+    {
+      type_id |= ArenaBit;
     }
 
     RC get_rc()
@@ -180,7 +234,9 @@ namespace vbci
 
       if (loc.is_immutable())
       {
-        arc++;
+        if (!DeferredARC::cancel(this))
+          arc++;
+
         return;
       }
 
@@ -205,7 +261,7 @@ namespace vbci
 
       if (loc.is_immutable())
       {
-        if (--arc == 0)
+        if (!DeferredARC::defer(this) && (--arc == 0))
           collect_scc(this);
 
         return;
@@ -217,4 +273,10 @@ namespace vbci
         collect(this);
     }
   };
+
+  inline void DeferredARC::apply(Header* h, RC count)
+  {
+    if ((h->arc -= count) == 0)
+      collect_scc(h);
+  }
 }
@@ -33,6 +33,7 @@ namespace vbci
     BadFreeze,
     BadMerge,
     SchedulerAlreadyRunning,
+    StackOverflow,
   };
 
   using PC = size_t;
@@ -100,6 +101,8 @@ namespace vbci
         return "cannot merge regions: both have owners";
       case Error::SchedulerAlreadyRunning:
         return "scheduler already running";
+      case Error::StackOverflow:
+        return "stack overflow";
 
       default:
         assert(false);
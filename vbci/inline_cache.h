@@ -0,0 +1,95 @@
+#pragma once
+
+#include "logging.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <snmalloc/ds_core/defines.h>
+
+namespace vbci
+{
+  // A per-site cache of method lookups, keyed on the receiver type ID. Each
+  // entry packs a type ID and a function index into one word, so threads can
+  // share a cache without locking: a racing update can only replace one valid
+  // entry with another. Hits and misses are only counted while stats are being
+  // reported, and the counts are approximate.
+  struct InlineCache
+  {
+    static constexpr size_t Entries = 4;
+    static constexpr uint64_t Empty = uint64_t(-1);
+    static constexpr uint32_t NoMethod = uint32_t(-1);
+
+    // Sites are looked up by every thread, so each cache starts on its own
+    // cache line, and the counters are on another.
+    static constexpr size_t CacheLine = 64;
+
+    alignas(CacheLine) std::atomic<uint64_t> entries[Entries];
+
+    // The next entry to evict. Races only pick a different victim.
+    std::atomic<uint8_t> cursor{0};
+
+    alignas(CacheLine) std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+
+    InlineCache()
+    {
+      for (auto& e : entries)
+        e.store(Empty, std::memory_order_relaxed);
+    }
+
+    SNMALLOC_FAST_PATH bool find(uint32_t type_id, uint32_t& func_idx)
+    {
+      for (auto& e : entries)
+      {
+        auto v = e.load(std::memory_order_relaxed);
+
+        if ((v >> 32) == type_id)
+        {
+          func_idx = uint32_t(v);
+          count(hits);
+          return true;
+        }
+      }
+
+      count(misses);
+      return false;
+    }
+
+    void insert(uint32_t type_id, uint32_t func_idx)
+    {
+      auto v = (uint64_t(type_id) << 32) | func_idx;
+
+      // Fill an empty entry if there is one. Otherwise, evict an entry.
+      for (auto& e : entries)
+      {
+        auto expect = Empty;
+
+        if (e.compare_exchange_strong(
+              expect, v, std::memory_order_relaxed, std::memory_order_relaxed))
+          return;
+      }
+
+      auto victim = cursor.load(std::memory_order_relaxed);
+      cursor.store((victim + 1) % Entries, std::memory_order_relaxed);
+      entries[victim].store(v, std::memory_order_relaxed);
+    }
+
+    bool is_polymorphic()
+    {
+      return entries[1].load(std::memory_order_relaxed) != Empty;
+    }
+
+  private:
+    static void count(std::atomic<size_t>& c)
+    {
+      // Every thread shares these counters, so don't touch them on the lookup
+      // path unless they will be reported.
+      if (!logging::Info::active())
+        return;
+
+      // Not a read-modify-write: lost updates are acceptable for statistics.
+      c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+  };
+}
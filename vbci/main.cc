@@ -1,7 +1,11 @@
 // Copyright Microsoft and Project Verona Contributors.
 // SPDX-License-Identifier: MIT
+#include "blocking.h"
+#include "header.h"
 #include "logging.h"
 #include "program.h"
+#include "reclaim.h"
+#include "thread.h"
 
 #include <CLI/CLI.hpp>
 #include <thread>
@@ -19,6 +23,50 @@ int main(int argc, char** argv)
   size_t num_threads = std::thread::hardware_concurrency();
   app.add_option("-t,--threads", num_threads, "Scheduler threads.");
 
+  size_t blocking_threads = 4;
+  app
+    .add_option(
+      "--blocking-threads",
+      blocking_threads,
+      "Threads for calls to FFI symbols marked blocking.")
+    ->check(CLI::PositiveNumber);
+
+  bool predecode = false;
+  app.add_flag(
+    "--predecode",
+    predecode,
+    "Pre-decode bytecode into fixed-width words at load time.");
+
+  bool precompute_subtypes = false;
+  app.add_flag(
+    "--precompute-subtypes",
+    precompute_subtypes,
+    "Compute every subtype relation at load time.");
+
+  bool deferred_rc = false;
+  app.add_flag(
+    "--deferred-rc",
+    deferred_rc,
+    "Batch register stack RC changes and apply them at safe points.");
+
+  bool deferred_arc = false;
+  app.add_flag(
+    "--deferred-arc",
+    deferred_arc,
+    "Batch frozen object RC changes and apply them at safe points.");
+
+  bool background_reclaim = false;
+  app.add_flag(
+    "--background-reclaim",
+    background_reclaim,
+    "Release dead regions with nothing to finalize on a background thread.");
+
+  bool batch_behaviors = false;
+  app.add_flag(
+    "--batch-behaviors",
+    batch_behaviors,
+    "Schedule the behaviours queued by a behaviour together when it ends.");
+
   std::string log_level;
   app
     .add_option(
@@ -40,5 +88,12 @@ int main(int argc, char** argv)
   }
 
   LOG(Info) << "Running with " << num_threads << " threads";
+  Program::get().set_predecode(predecode);
+  Program::get().set_precompute_subtypes(precompute_subtypes);
+  DeferredStackRC::set_enabled(deferred_rc);
+  DeferredARC::set_enabled(deferred_arc);
+  Reclaimer::set_enabled(background_reclaim);
+  Thread::set_batch_behaviors(batch_behaviors);
+  BlockingPool::set_threads(blocking_threads);
   return Program::get().run(file, num_threads, app.remaining());
 }
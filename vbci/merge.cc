@@ -115,6 +115,7 @@ namespace vbci
 
   void merge(const Register& a, const Register& b)
   {
+    DeferredStackRC::reconcile();
     bool a_stack = merge_is_stack(a);
     bool b_stack = merge_is_stack(b);
     Region* a_r = merge_region(a);
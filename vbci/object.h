@@ -57,12 +57,11 @@ namespace vbci
 
     size_t field(size_t field)
     {
-      auto& c = cls();
-      auto find = c.field_map.find(field);
-      if (find == c.field_map.end())
+      auto find = Program::get().field(cls(), field);
+      if (!find)
         Value::error(Error::BadField);
 
-      return find->second;
+      return *find;
     }
 
     Function* finalizer()
@@ -105,6 +104,10 @@ namespace vbci
                  << "@" << this;
 
       auto& c = cls();
+
+      if (!c.needs_finalize())
+        return;
+
       auto& f = c.fields;
       auto fin = c.finalizer();
 
@@ -0,0 +1,215 @@
+#include "pool.h"
+
+#include <mutex>
+
+namespace vbci
+{
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  // Counts from threads that have exited.
+  static std::mutex stats_mutex;
+  static Pool::Stats exited_stats;
+
+  // Blocks freed during thread exit, after the pool is gone, or on a thread
+  // that has disabled pooling, go straight back to the allocator.
+  static thread_local bool thread_pool_disabled = false;
+
+  struct ThreadPool
+  {
+    FreeBlock* lists[Pool::NumClasses] = {};
+    size_t counts[Pool::NumClasses] = {};
+    Pool::Stats stats;
+
+    ~ThreadPool()
+    {
+      for (auto& list : lists)
+      {
+        while (list)
+        {
+          auto next = list->next;
+          delete[] reinterpret_cast<uint8_t*>(list);
+          list = next;
+        }
+      }
+
+      thread_pool_disabled = true;
+      std::lock_guard lock(stats_mutex);
+      exited_stats.allocs += stats.allocs;
+      exited_stats.reused += stats.reused;
+      exited_stats.frees += stats.frees;
+      exited_stats.released += stats.released;
+    }
+  };
+
+  static thread_local ThreadPool thread_pool;
+
+  static size_t size_class(size_t size)
+  {
+    return (size - 1) / Pool::Granularity;
+  }
+
+  void Pool::set_limit(size_t size)
+  {
+    limit.store(
+      (size < MaxSize) ? size : MaxSize, std::memory_order_relaxed);
+  }
+
+  void Pool::disable()
+  {
+    thread_pool_disabled = true;
+  }
+
+  void* Pool::alloc(size_t size)
+  {
+    if (thread_pool_disabled)
+      return new uint8_t[size];
+
+    auto& tp = thread_pool;
+    tp.stats.allocs++;
+
+    if (size <= limit.load(std::memory_order_relaxed))
+    {
+      auto c = size_class(size);
+
+      if (auto block = tp.lists[c])
+      {
+        tp.lists[c] = block->next;
+        tp.counts[c]--;
+        tp.stats.reused++;
+        return block;
+      }
+
+      // Allocate the whole size class, so the block can be reused for any
+      // size in it.
+      size = (c + 1) * Granularity;
+    }
+
+    return new uint8_t[size];
+  }
+
+  void Pool::free(void* p, size_t size)
+  {
+    if (thread_pool_disabled)
+    {
+      delete[] static_cast<uint8_t*>(p);
+      return;
+    }
+
+    auto& tp = thread_pool;
+    tp.stats.frees++;
+
+    if (size <= limit.load(std::memory_order_relaxed))
+    {
+      auto c = size_class(size);
+
+      if (tp.counts[c] < MaxCached)
+      {
+        auto block = static_cast<FreeBlock*>(p);
+        block->next = tp.lists[c];
+        tp.lists[c] = block;
+        tp.counts[c]++;
+        return;
+      }
+    }
+
+    tp.stats.released++;
+    delete[] static_cast<uint8_t*>(p);
+  }
+
+  void Pool::Batch::free(void* p, size_t size)
+  {
+    frees++;
+
+    if (size > limit.load(std::memory_order_relaxed))
+    {
+      released++;
+      delete[] static_cast<uint8_t*>(p);
+      return;
+    }
+
+    auto c = size_class(size);
+    auto block = static_cast<FreeBlock*>(p);
+    block->next = heads[c];
+    heads[c] = block;
+
+    if (!tails[c])
+      tails[c] = block;
+
+    counts[c]++;
+  }
+
+  Pool::Batch::~Batch()
+  {
+    if (thread_pool_disabled)
+    {
+      for (auto block : heads)
+      {
+        while (block)
+        {
+          auto next = block->next;
+          delete[] reinterpret_cast<uint8_t*>(block);
+          block = next;
+        }
+      }
+
+      return;
+    }
+
+    auto& tp = thread_pool;
+
+    for (size_t c = 0; c < NumClasses; c++)
+    {
+      auto block = heads[c];
+
+      if (!block)
+        continue;
+
+      // A chain that fits is spliced onto the free list whole. The rest of a
+      // chain that doesn't fit is released.
+      auto room = MaxCached - tp.counts[c];
+
+      if (counts[c] <= room)
+      {
+        tails[c]->next = tp.lists[c];
+        tp.lists[c] = block;
+        tp.counts[c] += counts[c];
+        continue;
+      }
+
+      for (; room > 0; room--)
+      {
+        auto next = block->next;
+        block->next = tp.lists[c];
+        tp.lists[c] = block;
+        tp.counts[c]++;
+        block = next;
+      }
+
+      while (block)
+      {
+        auto next = block->next;
+        delete[] reinterpret_cast<uint8_t*>(block);
+        released++;
+        block = next;
+      }
+    }
+
+    tp.stats.frees += frees;
+    tp.stats.released += released;
+  }
+
+  Pool::Stats Pool::stats()
+  {
+    auto& tp = thread_pool;
+    std::lock_guard lock(stats_mutex);
+    Stats s = exited_stats;
+    s.allocs += tp.stats.allocs;
+    s.reused += tp.stats.reused;
+    s.frees += tp.stats.frees;
+    s.released += tp.stats.released;
+    return s;
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace vbci
+{
+  struct FreeBlock;
+
+  // Per-thread free lists of region allocations, by size class. Sizes are
+  // rounded up to a multiple of Granularity, and only sizes up to the limit
+  // set from the program's classes are pooled. A block may be freed on a
+  // different thread than the one that allocated it.
+  struct Pool
+  {
+    static constexpr size_t Granularity = 16;
+    static constexpr size_t MaxSize = 1024;
+    static constexpr size_t NumClasses = MaxSize / Granularity;
+
+    // Each free list keeps at most this many blocks.
+    static constexpr size_t MaxCached = 256;
+
+    struct Stats
+    {
+      size_t allocs = 0;
+      size_t reused = 0;
+      size_t frees = 0;
+      size_t released = 0;
+    };
+
+    // Blocks freed together, such as the contents of a dead region. Pooled
+    // blocks are chained by size class, and each chain is handed to the
+    // thread's free list at once when the batch ends.
+    struct Batch
+    {
+      FreeBlock* heads[NumClasses] = {};
+      FreeBlock* tails[NumClasses] = {};
+      size_t counts[NumClasses] = {};
+      size_t frees = 0;
+      size_t released = 0;
+
+      void free(void* p, size_t size);
+      ~Batch();
+    };
+
+    static void set_limit(size_t size);
+
+    // Stop pooling on this thread, so the blocks it frees go straight back to
+    // the allocator. For threads that free but never allocate, where pooled
+    // blocks would never be reused.
+    static void disable();
+    static void* alloc(size_t size);
+    static void free(void* p, size_t size);
+    static Stats stats();
+
+  private:
+    static inline std::atomic<size_t> limit{0};
+  };
+}
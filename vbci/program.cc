@@ -1,13 +1,19 @@
 #include "program.h"
 
 #include "array.h"
+#include "blocking.h"
 #include "cown.h"
 #include "freeze.h"
+#include "reclaim.h"
+#include "region_rc.h"
 #include "thread.h"
+#include "vmem.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <dlfcn.h>
 #include <format>
+#include <iterator>
 #include <verona.h>
 #include <zstd.h>
 
@@ -96,6 +102,61 @@ namespace vbci
     return memo_slots.at(index);
   }
 
+  Function*
+  Program::lookup_method_slow(InlineCache& ic, const Value& v, size_t w)
+  {
+    auto f = v.method(w);
+    auto type_id = v.type_id();
+
+    if (type_id != DynId)
+    {
+      auto idx = f ? uint32_t(f - functions.data()) : InlineCache::NoMethod;
+      ic.insert(type_id, idx);
+    }
+
+    return f;
+  }
+
+  void Program::print_stats()
+  {
+    if (!logging::Info::active())
+      return;
+
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t polymorphic = 0;
+
+    for (auto& ic : inline_caches)
+    {
+      hits += ic.hits.load(std::memory_order_relaxed);
+      misses += ic.misses.load(std::memory_order_relaxed);
+      polymorphic += ic.is_polymorphic();
+    }
+
+    LOG(Info) << "Inline caches: " << inline_caches.size() << " sites ("
+              << polymorphic << " polymorphic), " << hits << " hits, "
+              << misses << " misses";
+
+    auto pool = Pool::stats();
+    LOG(Info) << "Region pools: " << pool.allocs << " allocations ("
+              << pool.reused << " reused), " << pool.frees << " frees ("
+              << pool.released << " released)";
+
+    auto fz = freeze_stats();
+    LOG(Info) << "Freeze: " << fz.freezes << " calls, " << fz.objects
+              << " objects, " << (fz.total_ns / 1000) << "us total, "
+              << (fz.max_ns / 1000) << "us max";
+
+    auto rc = Reclaimer::stats();
+    LOG(Info) << "Background reclaim: " << rc.regions << " regions, "
+              << rc.max_queued << " max queued";
+
+    auto cb = callback_stats();
+    LOG(Info) << "Callbacks: " << cb.calls << " calls (" << cb.prechecked
+              << " prechecked), " << (cb.total_ns / 1000) << "us total, "
+              << (cb.max_ns / 1000) << "us max";
+  }
+
   void Program::init_memo_slot(size_t index)
   {
     auto& slot = memo_slots.at(index);
@@ -207,6 +268,9 @@ namespace vbci
     ValueTransfer ret =
       Thread::run_async(typeid_cown_none, &functions.at(MainFuncId));
     sched.run();
+    BlockingPool::stop();
+    Reclaimer::stop();
+    print_stats();
 
     auto ret_val = ret.get_cown()->load();
     ret.field_dec();
@@ -430,20 +494,24 @@ namespace vbci
     return it->second;
   }
 
-  bool Program::subtype(uint32_t sub, uint32_t super)
+  bool Program::subtype_slow(uint32_t sub, uint32_t super)
   {
-    // Everything is a subtype of dynamic.
-    if (super == DynId)
-      return true;
+    auto result = subtype_uncached(sub, super);
 
-    // Dynamic is a subtype of nothing.
-    if (sub == DynId)
-      return false;
+    if ((sub < subtype_types) && (super < subtype_types))
+    {
+      // Racing threads compute the same result, so setting the bits twice is
+      // harmless.
+      auto bit = (sub * subtype_types + super) * 2;
+      subtype_cache[bit / 64].fetch_or(
+        uint64_t(1 | (result << 1)) << (bit % 64), std::memory_order_relaxed);
+    }
 
-    // If it's the same, we're done.
-    if (sub == super)
-      return true;
+    return result;
+  }
 
+  bool Program::subtype_uncached(uint32_t sub, uint32_t super)
+  {
     if (is_union(sub))
     {
       // All elements of sub must be subtypes of super.
@@ -532,7 +600,7 @@ namespace vbci
     constexpr auto no_value = size_t(-1);
     auto di_file = no_value;
     auto di_offset = 0;
-    auto cur_pc = func->labels.at(0);
+    auto cur_pc = code_pc(func->labels.at(0));
     auto di_pc = di + func->debug_info;
 
     // Read past the function name and the register names.
@@ -652,22 +720,37 @@ namespace vbci
 
   void Program::setup_strings()
   {
+    // Every string literal is laid out in one block, copied straight from the
+    // image.
+    auto align = [](size_t size) {
+      return (size + alignof(Array) - 1) & ~(alignof(Array) - 1);
+    };
+
+    size_t total = 0;
+
+    for (auto& str : strings)
+      total += align(Array::size_of(str.size() + 1, ffi_type_uint8.size));
+
+    string_block = std::make_unique_for_overwrite<uint8_t[]>(total);
     string_arrays.resize(strings.size());
+    auto mem = string_block.get();
 
     for (size_t i = 0; i < strings.size(); i++)
     {
-      auto& str = strings.at(i);
+      auto str = strings.at(i);
       auto str_size = str.size() + 1;
       auto arr = Array::create(
-        new uint8_t[Array::size_of(str_size, ffi_type_uint8.size)],
+        mem,
         Location::stack(),
         typeid_arg,
         ValueType::U8,
         str_size,
         ffi_type_uint8.size);
 
-      auto p = arr->get_pointer();
-      std::memcpy(p, str.c_str(), str_size);
+      mem += align(Array::size_of(str_size, ffi_type_uint8.size));
+      auto p = static_cast<char*>(arr->get_pointer());
+      std::memcpy(p, str.data(), str.size());
+      p[str.size()] = '\0';
       // Array size honestly includes the null terminator.
       // The string wrapper (in Verona) sets len = data.size - 1.
       arr->immortalize();
@@ -677,10 +760,8 @@ namespace vbci
 
   void Program::cleanup_strings()
   {
-    for (auto* arr : string_arrays)
-      delete[] reinterpret_cast<uint8_t*>(arr);
-
     string_arrays.clear();
+    string_block.reset();
   }
 
   void Program::setup_value_type()
@@ -734,24 +815,24 @@ namespace vbci
     argv->immortalize();
   }
 
-  bool Program::load()
+  bool Program::map_image()
   {
-    content.clear();
-    functions.clear();
-    classes.clear();
-    string_arrays.clear();
+    content = {};
+    image_copy.clear();
 
-    libs.clear();
-    symbols.clear();
-    setup_value_type();
+    if (image)
+      vmem::unmap_file(image, image_size);
 
-    argv = nullptr;
+    image = vmem::map_file(file, image_size);
 
-    di = PC(-1);
-    di_strings.clear();
-    source_files.clear();
+    if (image)
+    {
+      content = {static_cast<const uint8_t*>(image), image_size};
+      return true;
+    }
 
-    std::ifstream f(file, std::ios::binary | std::ios::in | std::ios::ate);
+    // Fall back to reading files that can't be mapped, such as pipes.
+    std::ifstream f(file, std::ios::binary | std::ios::in);
 
     if (!f)
     {
@@ -759,17 +840,47 @@ namespace vbci
       return false;
     }
 
-    size_t size = f.tellg();
-    f.seekg(0, std::ios::beg);
-    content.resize(size);
-    f.read(reinterpret_cast<char*>(&content.at(0)), size);
+    image_copy.assign(
+      std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
 
-    if (!f)
+    if (f.bad())
     {
       LOG(Error) << file << ": couldn't read" << std::endl;
       return false;
     }
 
+    content = image_copy;
+    return true;
+  }
+
+  bool Program::load()
+  {
+    code_image.clear();
+    code.clear();
+    code_pcs.clear();
+    functions.clear();
+    classes.clear();
+    string_arrays.clear();
+
+    libs.clear();
+    symbols.clear();
+    inline_caches.clear();
+    inline_cache_pcs.clear();
+    method_table.clear();
+    field_table.clear();
+    subtype_cache.reset();
+    subtype_types = 0;
+    setup_value_type();
+
+    argv = nullptr;
+
+    di = PC(-1);
+    di_strings.clear();
+    source_files.clear();
+
+    if (!map_image())
+      return false;
+
     PC pc = 0;
 
     if (uleb(pc) != MagicNumber)
@@ -835,7 +946,7 @@ namespace vbci
     init_funcs.reserve(num_libs);
     for (size_t i = 0; i < num_libs; i++)
     {
-      libs.emplace_back(strings.at(uleb(pc)));
+      libs.emplace_back(std::string(strings.at(uleb(pc))));
 
       auto init_id = uleb(pc);
       init_funcs.push_back(
@@ -846,9 +957,10 @@ namespace vbci
     for (size_t i = 0; i < num_symbols; i++)
     {
       auto& lib = libs.at(uleb(pc));
-      auto& name = strings.at(uleb(pc));
-      auto& version = strings.at(uleb(pc));
-      bool vararg = uleb(pc);
+      auto name = std::string(strings.at(uleb(pc)));
+      auto version = std::string(strings.at(uleb(pc)));
+      auto flags = uleb(pc);
+      bool vararg = (flags & SymbolVararg) != 0;
       auto func = lib.symbol(name, version);
 
       if (!func)
@@ -866,6 +978,9 @@ namespace vbci
         symbol.param(uleb(pc));
 
       symbol.ret(uleb(pc));
+
+      if (flags & SymbolBlocking)
+        symbol.set_blocking(uleb(pc));
     }
 
     // Functions.
@@ -902,6 +1017,23 @@ namespace vbci
     for (auto& t : complex_types)
       parse_complex_type(t, type_id++, pc);
 
+    // Reject malformed types here, so that subtype checks can't fail later.
+    auto num_types = min_complex_type_id + complex_types.size();
+
+    for (auto& t : complex_types)
+    {
+      auto bad = t.tag > TypeTag::Tuple;
+
+      for (auto c : t.children)
+        bad |= (c != DynId) && (c >= num_types);
+
+      if (bad)
+      {
+        LOG(Error) << file << ": has a malformed type" << std::endl;
+        return false;
+      }
+    }
+
     typeid_cown_none = min_complex_type_id;
     assert(complex_type(typeid_cown_none).tag == TypeTag::Cown);
     assert(complex_type(typeid_cown_none).children.at(0) == +ValueType::None);
@@ -944,12 +1076,19 @@ namespace vbci
       }
     }
 
+    size_t max_class_size = 0;
+
     for (auto& cls : classes)
     {
       if (!fixup_methods(cls))
         return false;
+
+      max_class_size = std::max(max_class_size, cls.size);
     }
 
+    // Pool region allocations up to the size of the largest class.
+    Pool::set_limit(RegionRC::alloc_size(max_class_size));
+
     // Function label locations are relative to the code section. Make them
     // absolute.
     auto memo_count = uleb(pc);
@@ -959,12 +1098,32 @@ namespace vbci
 
     auto code_size = uleb(pc);
 
+    if (code_size > content.size() - pc)
+    {
+      LOG(Error) << file << ": has a truncated code section" << std::endl;
+      return false;
+    }
+
+    code_image.assign(content.begin(), content.begin() + pc + code_size);
+
     for (auto& func : functions)
     {
       for (auto& label : func.labels)
         label += pc;
     }
 
+    for (auto& func : functions)
+    {
+      if (!verify_function(func, pc, pc + code_size))
+        return false;
+    }
+
+    if (predecode)
+      predecode_code(pc, pc + code_size);
+
+    init_inline_caches();
+    init_subtype_cache();
+
     // Debug info.
     pc += code_size;
 
@@ -976,6 +1135,399 @@ namespace vbci
     return true;
   }
 
+  // Operand kinds for each op code, used to verify function bodies at load
+  // time:
+  //   r = register, c = class ID, t = type ID, f = function ID, l = label,
+  //   s = string ID, y = symbol ID, m = memo slot, k = unchecked constant,
+  //   v = value type followed by a literal of that type.
+  static std::string_view operand_kinds(Op op)
+  {
+    switch (op)
+    {
+      case Op::Const:
+        return "rv";
+      case Op::String:
+        return "rs";
+      case Op::Convert:
+        return "rkr";
+      case Op::New:
+      case Op::Stack:
+        return "rc";
+      case Op::Heap:
+        return "rrc";
+      case Op::Region:
+        return "rkc";
+      case Op::NewArray:
+      case Op::StackArray:
+        return "rrt";
+      case Op::NewArrayConst:
+      case Op::StackArrayConst:
+        return "rtk";
+      case Op::HeapArray:
+        return "rrrt";
+      case Op::HeapArrayConst:
+        return "rrtk";
+      case Op::RegionArray:
+        return "rkrt";
+      case Op::RegionArrayConst:
+        return "rktk";
+      case Op::FieldRefMove:
+      case Op::FieldRefCopy:
+      case Op::ArrayRefMoveConst:
+      case Op::ArrayRefCopyConst:
+      case Op::LookupDynamic:
+        return "rrk";
+      case Op::LookupFFI:
+      case Op::FFI:
+      case Op::FFIMany:
+        return "ry";
+      case Op::CallStatic:
+        return "rf";
+      case Op::WhenStatic:
+        return "rtf";
+      case Op::WhenDynamic:
+        return "rtr";
+      case Op::Typetest:
+        return "rrt";
+      case Op::TailcallStatic:
+        return "f";
+      case Op::Cond:
+        return "rll";
+      case Op::Jump:
+        return "l";
+      case Op::FFIStruct:
+        return "rt";
+      case Op::FFILoad:
+        return "rrrrt";
+      case Op::FFIStore:
+        return "rrrrrt";
+      case Op::MemoLoad:
+        return "rm";
+      case Op::CondEq:
+      case Op::CondNe:
+      case Op::CondLt:
+      case Op::CondLe:
+      case Op::CondGt:
+      case Op::CondGe:
+        return "rrrll";
+      case Op::AddConst:
+      case Op::SubConst:
+        return "rrrv";
+      case Op::FieldLoad:
+        return "rrkr";
+      case Op::ArgMoveCallStatic:
+      case Op::ArgCopyCallStatic:
+        return "rrf";
+
+      case Op::Drop:
+      case Op::ArgMove:
+      case Op::ArgCopy:
+      case Op::TailcallDynamic:
+      case Op::Return:
+      case Op::Raise:
+      case Op::GetRaise:
+      case Op::Const_E:
+      case Op::Const_Pi:
+      case Op::Const_Inf:
+      case Op::Const_NaN:
+      case Op::AddExternal:
+      case Op::RemoveExternal:
+      case Op::ArrayCopy:
+      case Op::ArrayFill:
+      case Op::ArrayCompare:
+        return "r";
+
+      case Op::Copy:
+      case Op::Move:
+      case Op::Freeze:
+      case Op::RegisterRef:
+      case Op::Load:
+      case Op::CallDynamic:
+      case Op::TryCallDynamic:
+      case Op::Neg:
+      case Op::Not:
+      case Op::Abs:
+      case Op::Ceil:
+      case Op::Floor:
+      case Op::Exp:
+      case Op::Log:
+      case Op::Sqrt:
+      case Op::Cbrt:
+      case Op::IsInf:
+      case Op::IsNaN:
+      case Op::Sin:
+      case Op::Cos:
+      case Op::Tan:
+      case Op::Asin:
+      case Op::Acos:
+      case Op::Atan:
+      case Op::Sinh:
+      case Op::Cosh:
+      case Op::Tanh:
+      case Op::Asinh:
+      case Op::Acosh:
+      case Op::Atanh:
+      case Op::Bits:
+      case Op::Len:
+      case Op::Ptr:
+      case Op::Read:
+      case Op::Pin:
+      case Op::Unpin:
+      case Op::SetRaise:
+      case Op::MakeCallback:
+      case Op::CodePtrCallback:
+      case Op::FreeCallback:
+        return "rr";
+
+      case Op::ArrayRefMove:
+      case Op::ArrayRefCopy:
+      case Op::StoreMove:
+      case Op::StoreCopy:
+      case Op::Merge:
+      case Op::Add:
+      case Op::Sub:
+      case Op::Mul:
+      case Op::Div:
+      case Op::Mod:
+      case Op::Pow:
+      case Op::And:
+      case Op::Or:
+      case Op::Xor:
+      case Op::Shl:
+      case Op::Shr:
+      case Op::Eq:
+      case Op::Ne:
+      case Op::Lt:
+      case Op::Le:
+      case Op::Gt:
+      case Op::Ge:
+      case Op::Min:
+      case Op::Max:
+      case Op::LogBase:
+      case Op::Atan2:
+        return "rrr";
+
+      default:
+        return {};
+    }
+  }
+
+  static bool is_terminator(Op op)
+  {
+    switch (op)
+    {
+      case Op::TailcallStatic:
+      case Op::TailcallDynamic:
+      case Op::Return:
+      case Op::Raise:
+      case Op::Cond:
+      case Op::Jump:
+      case Op::CondEq:
+      case Op::CondNe:
+      case Op::CondLt:
+      case Op::CondLe:
+      case Op::CondGt:
+      case Op::CondGe:
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  bool Program::verify_uleb(PC& pc, PC end, uint64_t& value)
+  {
+    constexpr size_t max_bytes = 10;
+    value = 0;
+
+    for (size_t i = 0; i < max_bytes; i++)
+    {
+      if (pc >= end)
+        return false;
+
+      auto b = code_image[pc++];
+      value |= (uint64_t(b) & 0x7F) << (7 * i);
+
+      if ((b & 0x80) == 0)
+        return true;
+    }
+
+    return false;
+  }
+
+  bool Program::verify_function(Function& f, PC start, PC end)
+  {
+    auto num_types = min_complex_type_id + complex_types.size();
+    uint64_t u;
+
+    auto fail = [&](PC pc, const char* msg) {
+      LOG(Error) << file << ": " << fallback_function(&f) << " (pc=" << pc
+                 << "): " << msg << std::endl;
+      return false;
+    };
+
+    for (auto label : f.labels)
+    {
+      if ((label < start) || (label >= end))
+        return fail(label, "label outside the code section");
+
+      auto pc = label;
+      Op op;
+
+      do
+      {
+        auto op_pc = pc;
+
+        if (!verify_uleb(pc, end, u))
+          return fail(op_pc, "truncated instruction");
+
+        op = static_cast<Op>(u);
+        auto kinds = operand_kinds(op);
+
+        if (kinds.empty())
+          return fail(op_pc, "unknown op code");
+
+        if (op == Op::LookupDynamic)
+          inline_cache_pcs.push_back(op_pc);
+
+        for (auto kind : kinds)
+        {
+          if (!verify_uleb(pc, end, u))
+            return fail(op_pc, "truncated instruction");
+
+          bool ok = true;
+
+          switch (kind)
+          {
+            case 'r':
+              ok = u < f.registers;
+              break;
+
+            case 'c':
+              ok = u < classes.size();
+              break;
+
+            case 't':
+              ok = (u == DynId) || (u < num_types);
+              break;
+
+            case 'f':
+              ok = u < functions.size();
+              break;
+
+            case 'l':
+              ok = u < f.labels.size();
+              break;
+
+            case 's':
+              ok = u < strings.size();
+              break;
+
+            case 'y':
+              ok = u < symbols.size();
+              break;
+
+            case 'm':
+              ok = u < memo_func_ids.size();
+              break;
+
+            case 'v':
+              // Every value type other than none carries a literal.
+              if (u > +ValueType::Ptr)
+                ok = false;
+              else if (u != +ValueType::None)
+                ok = verify_uleb(pc, end, u);
+              break;
+
+            default:
+              break;
+          }
+
+          if (!ok)
+            return fail(op_pc, "invalid operand");
+        }
+      } while (!is_terminator(op));
+    }
+
+    return true;
+  }
+
+  void Program::predecode_code(PC start, PC end)
+  {
+    // Every opcode and operand in the code section is a single ULEB128 value,
+    // so the whole section can be decoded without knowing opcode arity. The
+    // byte offset of each word is kept for debug info.
+    code.reserve(end - start);
+    code_pcs.reserve(end - start + 1);
+
+    for (PC pc = start; pc < end;)
+    {
+      code_pcs.push_back(pc);
+      code.push_back(uleb(pc, code_image));
+    }
+
+    code_pcs.push_back(end);
+
+    // Labels become word indices.
+    for (auto& func : functions)
+    {
+      for (auto& label : func.labels)
+      {
+        auto it = std::lower_bound(code_pcs.begin(), code_pcs.end(), label);
+        label = it - code_pcs.begin();
+      }
+    }
+  }
+
+  void Program::init_inline_caches()
+  {
+    // Give each LookupDynamic site a cache. Sites are found by binary search
+    // on their pcs, which keeps the bytecode format unchanged and costs a word
+    // per site rather than per instruction.
+    inline_caches = std::vector<InlineCache>(inline_cache_pcs.size());
+    std::sort(inline_cache_pcs.begin(), inline_cache_pcs.end());
+
+    if (!predecode)
+      return;
+
+    for (auto& pc : inline_cache_pcs)
+    {
+      auto it = std::lower_bound(code_pcs.begin(), code_pcs.end(), pc);
+      pc = it - code_pcs.begin();
+    }
+  }
+
+  void Program::init_subtype_cache()
+  {
+    // Programs with very many types only cache the lower type IDs, which
+    // include every class.
+    constexpr size_t MaxSubtypeCacheTypes = 4096;
+    auto types = std::min(
+      size_t(min_complex_type_id) + complex_types.size(), MaxSubtypeCacheTypes);
+    auto words = (types * types * 2 + 63) / 64;
+
+    subtype_cache = std::make_unique<std::atomic<uint64_t>[]>(words);
+    subtype_types = types;
+
+    if (!precompute_subtypes)
+      return;
+
+    // Load has rejected malformed types, so none of these checks can fail.
+    for (uint32_t sub = 0; sub < types; sub++)
+    {
+      for (uint32_t super = 0; super < types; super++)
+        subtype(sub, super);
+    }
+  }
+
+  PC Program::code_pc(PC pc)
+  {
+    if (!predecode || (pc >= code_pcs.size()))
+      return pc;
+
+    return code_pcs[pc];
+  }
+
   bool Program::parse_function(Function& f, PC& pc)
   {
     f.registers = uleb(pc);
@@ -1021,7 +1573,7 @@ namespace vbci
     for (size_t i = 0; i < num_fields; i++)
     {
       auto& f = cls.fields.at(i);
-      cls.field_map.emplace(uleb(pc), i);
+      cls.field_map.emplace_back(uleb(pc), i);
       f.type_id = uleb(pc);
     }
 
@@ -1037,7 +1589,8 @@ namespace vbci
     {
       auto method_id = uleb(pc);
       auto func_id = uleb(pc);
-      cls.methods.emplace(method_id, reinterpret_cast<Function*>(func_id));
+      cls.methods.emplace_back(
+        method_id, reinterpret_cast<Function*>(func_id));
     }
 
     return true;
@@ -1062,6 +1615,26 @@ namespace vbci
       }
     }
 
+    // Lay out the class's rows in the method and field tables. If a name
+    // appears more than once, the first entry wins.
+    auto by_id = [](auto& a, auto& b) { return a.first < b.first; };
+    auto same_id = [](auto& a, auto& b) { return a.first == b.first; };
+
+    std::stable_sort(cls.methods.begin(), cls.methods.end(), by_id);
+    cls.methods.erase(
+      std::unique(cls.methods.begin(), cls.methods.end(), same_id),
+      cls.methods.end());
+    cls.method_offset = method_table.place(cls.type_id, cls.methods);
+
+    if (!cls.methods.empty() && (cls.methods.front().first == FinalMethodId))
+      cls.final_fn = cls.methods.front().second;
+
+    std::stable_sort(cls.field_map.begin(), cls.field_map.end(), by_id);
+    cls.field_map.erase(
+      std::unique(cls.field_map.begin(), cls.field_map.end(), same_id),
+      cls.field_map.end());
+    cls.field_offset = field_table.place(cls.type_id, cls.field_map);
+
     // Calculate the class size.
     try
     {
@@ -1122,23 +1695,29 @@ namespace vbci
     }
   }
 
-  std::string Program::str(size_t& pc, std::vector<uint8_t>& from)
+  std::string_view Program::str(size_t& pc, std::span<const uint8_t> from)
   {
     auto size = uleb(pc, from);
-    auto str = std::string(from.begin() + pc, from.begin() + pc + size);
+
+    if ((pc + size) > from.size())
+      throw std::out_of_range("str");
+
+    auto str =
+      std::string_view(reinterpret_cast<const char*>(from.data() + pc), size);
     pc += size;
     return str;
   }
 
+  template<typename T>
   void Program::string_table(
-    size_t& pc, std::vector<uint8_t>& from, std::vector<std::string>& table)
+    size_t& pc, std::span<const uint8_t> from, std::vector<T>& table)
   {
     auto count = uleb(pc, from);
     table.clear();
     table.reserve(count);
 
     for (size_t i = 0; i < count; i++)
-      table.push_back(str(pc, from));
+      table.emplace_back(str(pc, from));
   }
 
   bool Program::di_decompress()
@@ -1147,14 +1726,15 @@ namespace vbci
       if (di == PC(-1))
         return;
 
-      auto cap = ZSTD_getFrameContentSize(&content.at(di), content.size() - di);
+      auto cap =
+        ZSTD_getFrameContentSize(content.data() + di, content.size() - di);
 
       if ((cap == ZSTD_CONTENTSIZE_ERROR) || (cap == ZSTD_CONTENTSIZE_UNKNOWN))
         return;
 
       di_content.resize(cap);
       auto decompressed_size = ZSTD_decompress(
-        di_content.data(), cap, &content.at(di), content.size() - di);
+        di_content.data(), cap, content.data() + di, content.size() - di);
 
       if (ZSTD_isError(decompressed_size))
       {
@@ -6,14 +6,21 @@
 #include "frame.h"
 #include "function.h"
 #include "ident.h"
+#include "inline_cache.h"
 #include "logging.h"
+#include "row_table.h"
 #include "value.h"
 
+#include <algorithm>
 #include <atomic>
 #include <bit>
 #include <fstream>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
 #include <vector>
 
 namespace vbci
@@ -32,9 +39,29 @@ namespace vbci
   {
   private:
     std::filesystem::path file;
-    std::vector<uint8_t> content;
-    std::vector<std::string> strings;
+
+    // The bytecode is mapped read-only where possible, so string literals are
+    // read straight from the image. It stays mapped until the next load, as
+    // debug info is read lazily. The mapping is MAP_PRIVATE, which doesn't
+    // snapshot pages that haven't been touched: if the file is truncated or
+    // rewritten while it's mapped, reads can raise SIGBUS or see the new
+    // bytes. Code never runs from the mapping, so the worst case is a crash or
+    // altered strings and debug info, never running unverified code.
+    const void* image = nullptr;
+    size_t image_size = 0;
+    std::vector<uint8_t> image_copy;
+    std::span<const uint8_t> content;
+
+    // Everything up to the end of the code section, copied out of the image.
+    // The code section is verified and executed from this copy, so changes to
+    // the file can't alter code after it has been verified.
+    std::vector<uint8_t> code_image;
+    std::vector<uint64_t> code;
+    std::vector<PC> code_pcs;
+    bool predecode = false;
+    std::vector<std::string_view> strings;
     std::vector<Array*> string_arrays;
+    std::unique_ptr<uint8_t[]> string_block;
 
     std::vector<Function> functions;
     std::vector<Class> classes;
@@ -48,6 +75,17 @@ namespace vbci
     std::vector<uint8_t> memo_slot_initializing;
     std::vector<size_t> memo_func_ids;
     std::vector<Symbol> symbols;
+    std::vector<InlineCache> inline_caches;
+    // The pc of each LookupDynamic site, sorted. A site's cache has the same
+    // index as its pc.
+    std::vector<PC> inline_cache_pcs;
+    RowTable<Function*> method_table;
+    RowTable<size_t> field_table;
+
+    // Two bits per (sub, super) pair: known, then result.
+    std::unique_ptr<std::atomic<uint64_t>[]> subtype_cache;
+    size_t subtype_types = 0;
+    bool precompute_subtypes = false;
 
     ffi_type ffi_type_value;
     std::vector<ffi_type*> ffi_type_value_elements;
@@ -91,6 +129,52 @@ namespace vbci
 
     Register& memo_slot(size_t index);
 
+    SNMALLOC_FAST_PATH Function* method(const Class& cls, size_t w)
+    {
+      auto f = method_table.find(cls.method_offset, cls.type_id, w);
+      return f ? *f : nullptr;
+    }
+
+    SNMALLOC_FAST_PATH const size_t* field(const Class& cls, size_t f)
+    {
+      return field_table.find(cls.field_offset, cls.type_id, f);
+    }
+
+    // Look up a method through the inline cache for the LookupDynamic
+    // instruction at `pc`.
+    SNMALLOC_FAST_PATH Function*
+    lookup_method(PC pc, const Value& v, size_t w)
+    {
+      auto type_id = v.type_id();
+      auto it =
+        std::lower_bound(inline_cache_pcs.begin(), inline_cache_pcs.end(), pc);
+      auto& ic = inline_caches[it - inline_cache_pcs.begin()];
+      uint32_t idx;
+
+      if (SNMALLOC_LIKELY((type_id != DynId) && ic.find(type_id, idx)))
+        return (idx == InlineCache::NoMethod) ? nullptr : &functions[idx];
+
+      return lookup_method_slow(ic, v, w);
+    }
+
+    // Fetch the next operand from the instruction stream. When the code
+    // section has been pre-decoded, every operand is a fixed-width word and
+    // the pc is a word index rather than a byte offset.
+    SNMALLOC_FAST_PATH uint64_t operand(size_t& pc)
+    {
+      if (SNMALLOC_UNLIKELY(predecode))
+        return code[pc++];
+
+      return code_uleb(pc);
+    }
+
+    SNMALLOC_FAST_PATH int64_t soperand(size_t& pc)
+    {
+      // This uses zigzag encoding.
+      auto value = operand(pc);
+      return (value >> 1) ^ -(value & 1);
+    }
+
     SNMALLOC_FAST_PATH int64_t sleb(size_t& pc)
     {
       // This uses zigzag encoding.
@@ -103,20 +187,63 @@ namespace vbci
       return uleb(pc, content);
     }
 
+    // Decode from the code section without bounds checks. This is only safe
+    // because the bytes are in `code_image`, which the program owns, and
+    // `load` verified every function body there. Never point this at the
+    // mapped image, which can change underneath us.
+    SNMALLOC_FAST_PATH uint64_t code_uleb(size_t& pc)
+    {
+      auto p = code_image.data() + pc;
+      uint64_t b = p[0];
+
+      if (SNMALLOC_LIKELY(b < 0x80))
+      {
+        pc += 1;
+        return b;
+      }
+
+      uint64_t value = b & 0x7F;
+      b = p[1];
+      value |= (b & 0x7F) << 7;
+
+      if (SNMALLOC_LIKELY(b < 0x80))
+      {
+        pc += 2;
+        return value;
+      }
+
+      size_t i = 2;
+
+      do
+      {
+        b = p[i];
+        value |= (b & 0x7F) << (7 * i);
+        i++;
+      } while (b >= 0x80);
+
+      pc += i;
+      return value;
+    }
+
     SNMALLOC_FAST_PATH uint64_t di_uleb(size_t& pc)
     {
       return uleb(pc, di_content);
     }
 
-    SNMALLOC_FAST_PATH uint64_t uleb(size_t& pc, std::vector<uint8_t>& from)
+    SNMALLOC_FAST_PATH uint64_t uleb(size_t& pc, std::span<const uint8_t> from)
     {
       constexpr uint64_t max_shift = (sizeof(uint64_t) * 8) - 1;
       uint64_t value = 0;
 
       for (uint64_t shift = 0; shift <= max_shift; shift += 7)
       {
-        value |= (uint64_t(from.at(pc)) & 0x7F) << shift;
-        if (SNMALLOC_LIKELY((from.at(pc++) & 0x80) == 0)) [[likely]]
+        if (pc >= from.size())
+          throw std::out_of_range("uleb");
+
+        auto b = from[pc++];
+        value |= (uint64_t(b) & 0x7F) << shift;
+
+        if (SNMALLOC_LIKELY((b & 0x80) == 0)) [[likely]]
           break;
       }
 
@@ -140,6 +267,22 @@ namespace vbci
       exit_code = code;
     }
 
+    void print_stats();
+
+    void set_predecode(bool value)
+    {
+      predecode = value;
+    }
+
+    void set_precompute_subtypes(bool value)
+    {
+      precompute_subtypes = value;
+    }
+
+    // Converts an interpreter pc to an offset in the code section. The two
+    // differ under --predecode, where the interpreter's pc counts words.
+    PC code_pc(PC pc);
+
     std::pair<ValueType, ffi_type*> layout_type_id(uint32_t type_id);
     std::pair<ValueType, ffi_type*> layout_union_type(ComplexType& t);
 
@@ -153,8 +296,34 @@ namespace vbci
     uint32_t uncown(uint32_t type_id);
     uint32_t unref(uint32_t type_id);
     uint32_t ref(uint32_t type_id);
-    bool subtype(uint32_t sub, uint32_t super);
+    SNMALLOC_FAST_PATH bool subtype(uint32_t sub, uint32_t super)
+    {
+      // Everything is a subtype of dynamic.
+      if (super == DynId)
+        return true;
+
+      // Dynamic is a subtype of nothing.
+      if (sub == DynId)
+        return false;
+
+      // If it's the same, we're done.
+      if (sub == super)
+        return true;
 
+      if (SNMALLOC_LIKELY((sub < subtype_types) && (super < subtype_types)))
+      {
+        auto bit = (sub * subtype_types + super) * 2;
+        auto bits = subtype_cache[bit / 64].load(std::memory_order_relaxed) >>
+          (bit % 64);
+
+        if (bits & 1)
+          return (bits & 2) != 0;
+      }
+
+      return subtype_slow(sub, super);
+    }
+
+    // The pc is an offset in the code section. See code_pc.
     std::string debug_info(Function* func, PC pc);
     std::string di_function(Function* func);
     std::string di_class(Class& cls);
@@ -166,17 +335,28 @@ namespace vbci
     void cleanup_strings();
     void setup_argv(std::vector<std::string>& args);
     bool load();
+    bool map_image();
+    bool verify_function(Function& f, PC start, PC end);
+    bool verify_uleb(PC& pc, PC end, uint64_t& value);
+    void predecode_code(PC start, PC end);
+    void init_inline_caches();
+    void init_subtype_cache();
+    bool subtype_slow(uint32_t sub, uint32_t super);
+    bool subtype_uncached(uint32_t sub, uint32_t super);
     bool parse_function(Function& f, PC& pc);
     bool parse_fields(Class& cls, PC& pc);
     bool parse_methods(Class& cls, PC& pc);
     bool fixup_methods(Class& cls);
     void parse_complex_type(ComplexType& t, uint32_t type_id, PC& pc);
     void init_memo_slot(size_t index);
+    Function* lookup_method_slow(InlineCache& ic, const Value& v, size_t w);
     std::string fallback_function(Function* func);
 
-    std::string str(size_t& pc, std::vector<uint8_t>& from);
+    std::string_view str(size_t& pc, std::span<const uint8_t> from);
+
+    template<typename T>
     void string_table(
-      size_t& pc, std::vector<uint8_t>& from, std::vector<std::string>& table);
+      size_t& pc, std::span<const uint8_t> from, std::vector<T>& table);
 
     bool di_decompress();
     SourceFile* get_source_file(size_t di_file);
@@ -0,0 +1,125 @@
+#include "reclaim.h"
+
+#include "pool.h"
+#include "region.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vbci
+{
+  struct ReclaimQueue
+  {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<Region*> queue;
+    std::thread thread;
+    bool stopping = false;
+    ReclaimStats stats{0, 0};
+
+    ~ReclaimQueue()
+    {
+      stop();
+    }
+
+    void push(Region* r)
+    {
+      {
+        std::lock_guard lock(mutex);
+
+        if (!thread.joinable())
+        {
+          stopping = false;
+          thread = std::thread([this]() { run(); });
+        }
+
+        queue.push_back(r);
+        stats.regions++;
+
+        if (queue.size() > stats.max_queued)
+          stats.max_queued = queue.size();
+      }
+
+      cv.notify_one();
+    }
+
+    void stop()
+    {
+      {
+        std::lock_guard lock(mutex);
+
+        if (!thread.joinable())
+          return;
+
+        stopping = true;
+      }
+
+      cv.notify_one();
+      thread.join();
+    }
+
+  private:
+    void run()
+    {
+      // No behaviour runs on this thread, so nothing would reuse pooled
+      // blocks. Hand them straight back to the allocator instead.
+      Pool::disable();
+
+      std::vector<Region*> batch;
+      std::unique_lock lock(mutex);
+
+      while (true)
+      {
+        cv.wait(lock, [this]() { return !queue.empty() || stopping; });
+
+        // Drain the queue before stopping.
+        if (queue.empty())
+          return;
+
+        batch.swap(queue);
+        lock.unlock();
+
+        for (auto r : batch)
+        {
+          LOG(Trace) << "Reclaiming region @" << r;
+          r->release_dead_objects();
+        }
+
+        batch.clear();
+        lock.lock();
+      }
+    }
+  };
+
+  static bool enabled = false;
+  static ReclaimQueue reclaim_queue;
+
+  void Reclaimer::set_enabled(bool value)
+  {
+    enabled = value;
+  }
+
+  bool Reclaimer::defer(Region* r)
+  {
+    // Frame-local regions are released when their frame returns, and are
+    // rarely large enough to be worth handing over.
+    if (!enabled || r->is_frame_local() || r->is_finalizable())
+      return false;
+
+    reclaim_queue.push(r);
+    return true;
+  }
+
+  void Reclaimer::stop()
+  {
+    reclaim_queue.stop();
+  }
+
+  ReclaimStats Reclaimer::stats()
+  {
+    std::lock_guard lock(reclaim_queue.mutex);
+    return reclaim_queue.stats;
+  }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+namespace vbci
+{
+  struct Region;
+
+  struct ReclaimStats
+  {
+    size_t regions;
+    size_t max_queued;
+  };
+
+  // Releases dead regions on a background thread, so the behaviour that drops
+  // the last reference to a large region doesn't pay for freeing it. Only
+  // regions with nothing to finalize are handed over, as releasing them runs
+  // no program code and touches nothing outside the region.
+  struct Reclaimer
+  {
+    static void set_enabled(bool value);
+
+    // Returns false if the region should be released on this thread.
+    static bool defer(Region* r);
+
+    // Waits for every handed over region to be released, and stops the
+    // background thread.
+    static void stop();
+
+    static ReclaimStats stats();
+  };
+}
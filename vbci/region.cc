@@ -1,6 +1,7 @@
 #include "region.h"
 
 #include "region_arena.h"
+#include "region_gc.h"
 #include "region_rc.h"
 #include "thread.h"
 #include "value.h"
@@ -26,6 +27,12 @@ namespace vbci
         return result;
       }
 
+      case RegionType::RegionGC:
+      {
+        auto result = new RegionGC(type, frame_depth);
+        return result;
+      }
+
       default:
         Value::error(Error::UnknownRegionType);
     }
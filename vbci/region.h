@@ -25,6 +25,9 @@ namespace vbci
     };
 
     Header* entry_point;
+
+    // The entry point an in-progress drag found for this region.
+    Header* drag_entry;
     RC stack_rc;
     RegionType type;
     bool cown_owned;
@@ -36,9 +39,14 @@ namespace vbci
     size_t frame_depth;
 
   protected:
+    // Set once the region holds an object or array with something to
+    // finalize. A region without one skips finalization when it dies.
+    bool finalizable = false;
+
     Region(RegionType type, size_t frame_depth = 0)
     : parent(nullptr),
       entry_point(nullptr),
+      drag_entry(nullptr),
       stack_rc(0),
       type(type),
       cown_owned(false),
@@ -142,6 +150,11 @@ namespace vbci
       return frame_depth > 0;
     }
 
+    bool is_finalizable() const
+    {
+      return finalizable;
+    }
+
     size_t get_frame_depth() const
     {
       return frame_depth;
@@ -228,6 +241,24 @@ namespace vbci
       return entry_point;
     }
 
+    // Returns false if a drag already reached this region through another
+    // entry point.
+    bool mark_drag_entry(Header* entry)
+    {
+      if (drag_entry)
+        return false;
+
+      drag_entry = entry;
+      return true;
+    }
+
+    Header* take_drag_entry()
+    {
+      auto entry = drag_entry;
+      drag_entry = nullptr;
+      return entry;
+    }
+
     void free_region()
     {
       assert(!has_owner());
@@ -240,4 +271,130 @@ namespace vbci
       return stack_rc;
     }
   };
+
+  // A small table of decrements that haven't been applied yet. An increment
+  // for the same target can cancel one instead.
+  template<typename T>
+  struct DeferredDecs
+  {
+    static constexpr size_t Entries = 16;
+
+    T* targets[Entries];
+    RC counts[Entries];
+    size_t size = 0;
+
+    bool cancel(T* t)
+    {
+      for (size_t i = 0; i < size; i++)
+      {
+        if (targets[i] != t)
+          continue;
+
+        if (--counts[i] == 0)
+        {
+          size--;
+          targets[i] = targets[size];
+          counts[i] = counts[size];
+        }
+
+        return true;
+      }
+
+      return false;
+    }
+
+    // Applies every buffered decrement with `fn(target, count)`.
+    template<typename F>
+    void flush(F&& fn)
+    {
+      // Applying a decrement can run finalizers, which can defer more
+      // decrements, so the table is emptied before the batch is applied.
+      T* batch_targets[Entries];
+      RC batch_counts[Entries];
+      auto n = size;
+
+      for (size_t i = 0; i < n; i++)
+      {
+        batch_targets[i] = targets[i];
+        batch_counts[i] = counts[i];
+      }
+
+      size = 0;
+
+      for (size_t i = 0; i < n; i++)
+        fn(batch_targets[i], batch_counts[i]);
+    }
+
+    template<typename F>
+    void defer(T* t, F&& fn)
+    {
+      for (size_t i = 0; i < size; i++)
+      {
+        if (targets[i] == t)
+        {
+          counts[i]++;
+          return;
+        }
+      }
+
+      if (size == Entries)
+      {
+        flush(fn);
+        defer(t, fn);
+        return;
+      }
+
+      targets[size] = t;
+      counts[size] = 1;
+      size++;
+    }
+  };
+
+  // Stack RC changes from registers, batched per thread. A decrement is
+  // buffered and applied at the next safe point, so until then the region's
+  // stack RC over-counts and the region can't be freed early. An increment
+  // cancels a buffered decrement, so a loop that moves references between
+  // registers doesn't touch the region's counters at all.
+  struct DeferredStackRC
+  {
+  private:
+    static inline bool enabled = false;
+    static inline thread_local DeferredDecs<Region> local;
+
+    static void apply(Region* r, RC count)
+    {
+      r->stack_dec(count);
+    }
+
+  public:
+    static void set_enabled(bool value)
+    {
+      enabled = value;
+    }
+
+    static void inc(Region* r)
+    {
+      if (!enabled || !local.cancel(r))
+        r->stack_inc();
+    }
+
+    // Returns false if the region has been freed.
+    static bool dec(Region* r)
+    {
+      if (!enabled || r->is_frame_local())
+        return r->stack_dec();
+
+      local.defer(r, apply);
+      return true;
+    }
+
+    // Applies every buffered decrement. This must be called before anything
+    // that reads a stack RC, frees a region, or lets a region leave the
+    // thread.
+    static void reconcile()
+    {
+      if (local.size > 0)
+        local.flush(apply);
+    }
+  };
 }
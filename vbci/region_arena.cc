@@ -0,0 +1,169 @@
+#include "region_arena.h"
+
+#include "array.h"
+#include "object.h"
+#include "region_ext.h"
+
+#include <algorithm>
+
+namespace vbci
+{
+  Object* RegionArena::object(Class& cls)
+  {
+    auto mem = alloc(cls.size);
+    auto loc = Location(this);
+    auto obj = Object::create(mem, cls, loc);
+    obj->mark_arena_alloc();
+    finalizable |= cls.needs_finalize();
+    stack_inc();
+    return obj;
+  }
+
+  Array* RegionArena::array(uint32_t type_id, size_t size)
+  {
+    auto content_type_id = Program::get().unarray(type_id);
+    auto rep = Program::get().layout_type_id(content_type_id);
+    auto mem = alloc(Array::size_of(size, rep.second->size));
+    auto loc = Location(this);
+    auto arr =
+      Array::create(mem, loc, type_id, rep.first, size, rep.second->size);
+    arr->mark_arena_alloc();
+    finalizable |= Array::needs_finalize(rep.first);
+    stack_inc();
+    return arr;
+  }
+
+  void* RegionArena::alloc(size_t size)
+  {
+    size = (size + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    size += sizeof(RCLink);
+    auto need = sizeof(size_t) + size;
+
+    if (!chunks || ((chunks->capacity - chunks->used) < need))
+    {
+      // Large allocations get a chunk of their own, which sits behind the
+      // current chunk so that it keeps bumping.
+      auto capacity = ArenaChunk::Size - sizeof(ArenaChunk);
+      auto chunk = ArenaChunk::create(this, std::max(capacity, need));
+
+      if (chunks && (need > capacity))
+      {
+        chunk->next = chunks->next;
+        chunks->next = chunk;
+        return unlinked(chunk->alloc(size));
+      }
+
+      chunk->next = chunks;
+      chunks = chunk;
+    }
+
+    return unlinked(chunks->alloc(size));
+  }
+
+  void* RegionArena::unlinked(void* mem)
+  {
+    auto link = static_cast<RCLink*>(mem);
+    link->prev = nullptr;
+    link->next = nullptr;
+    return link + 1;
+  }
+
+  void RegionArena::rfree(Header* h)
+  {
+    // Arena allocations are only freed with the arena.
+    auto link = RCLink::of(h);
+
+    if (link->is_linked())
+    {
+      link->unlink();
+      free_header(h);
+    }
+  }
+
+  void RegionArena::insert(Header* h)
+  {
+    LOG(Trace) << "Inserting header @" << h << " into RegionArena @" << this;
+    finalizable |= needs_finalize(h);
+
+    // An allocation returning to its own arena is found by walking the chunk
+    // again, and no longer holds the chunk.
+    if (is_own(h))
+    {
+      ArenaChunk::of(h)->refs.fetch_sub(1, std::memory_order_acq_rel);
+      return;
+    }
+
+    RCLink::of(h)->link(foreign);
+  }
+
+  bool RegionArena::remove(Header* h)
+  {
+    auto link = RCLink::of(h);
+
+    if (link->is_linked())
+    {
+      link->unlink();
+      return true;
+    }
+
+    // The allocation keeps its place in the chunk, but is skipped when the
+    // chunk is walked, as its location no longer names this region. It holds
+    // the chunk until it's freed.
+    assert(is_own(h));
+    ArenaChunk::of(h)->refs.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool RegionArena::is_finalizing()
+  {
+    return true;
+  }
+
+  bool RegionArena::begin_finalizing()
+  {
+    if (finalizing)
+      return false;
+
+    finalizing = true;
+    return true;
+  }
+
+  void RegionArena::finalize_contents()
+  {
+    auto& program = Program::get();
+    assert(finalizing);
+
+    if (!finalizable)
+      return;
+
+    for_each_header([&](Header* h) {
+      if (program.is_array(h->get_type_id()))
+        static_cast<Array*>(h)->finalize();
+      else
+        static_cast<Object*>(h)->finalize();
+    });
+  }
+
+  void RegionArena::release_dead_objects()
+  {
+    for (auto link = foreign.next; link != &foreign;)
+    {
+      auto h = link->header();
+      link = link->next;
+      free_header(h);
+    }
+
+    // Chunks holding departed allocations are freed with the last of them.
+    // Clearing the arena first means a new arena at the same address can't
+    // mistake them for its own.
+    while (chunks)
+    {
+      auto chunk = chunks;
+      chunks = chunk->next;
+      chunk->arena.store(nullptr, std::memory_order_release);
+      ArenaChunk::release(chunk);
+    }
+
+    delete this;
+  }
+}
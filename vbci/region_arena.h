@@ -1,23 +1,153 @@
 #pragma once
 
+#include "header.h"
+#include "program.h"
+#include "region.h"
 #include "region_rc.h"
 
+#include <atomic>
+#include <new>
+
 namespace vbci
 {
-  struct RegionArena : public RegionRC
+  struct RegionArena;
+
+  // A block of arena memory. Every allocation is preceded by its size, so a
+  // chunk can be walked from the start, and then by its RCLink, so it can be
+  // linked into another region when it leaves the arena. Chunks are aligned to their minimum
+  // size, so the chunk holding an allocation can be found from its address.
+  // A chunk is counted once by its arena, and once by each allocation that
+  // has left the arena. It's freed when the last of them lets go.
+  struct ArenaChunk
+  {
+    static constexpr size_t Size = 64 * 1024;
+
+    ArenaChunk* next;
+    std::atomic<RegionArena*> arena;
+    size_t used;
+    size_t capacity;
+    std::atomic<size_t> refs;
+
+    static ArenaChunk* create(RegionArena* arena, size_t capacity)
+    {
+      auto bytes = sizeof(ArenaChunk) + capacity;
+      auto mem = ::operator new(bytes, std::align_val_t(Size));
+      auto chunk = new (mem) ArenaChunk;
+      chunk->next = nullptr;
+      chunk->arena.store(arena, std::memory_order_relaxed);
+      chunk->used = 0;
+      chunk->capacity = capacity;
+      chunk->refs.store(1, std::memory_order_relaxed);
+      return chunk;
+    }
+
+    static void release(ArenaChunk* chunk)
+    {
+      if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        chunk->~ArenaChunk();
+        ::operator delete(chunk, std::align_val_t(Size));
+      }
+    }
+
+    static ArenaChunk* of(Header* h)
+    {
+      return reinterpret_cast<ArenaChunk*>(
+        reinterpret_cast<uintptr_t>(h) & ~(Size - 1));
+    }
+
+    uint8_t* data()
+    {
+      return reinterpret_cast<uint8_t*>(this + 1);
+    }
+
+    void* alloc(size_t size)
+    {
+      auto p = data() + used;
+      *reinterpret_cast<size_t*>(p) = size;
+      used += sizeof(size_t) + size;
+      return p + sizeof(size_t);
+    }
+
+    void for_each_header(auto&& fn)
+    {
+      for (size_t offset = 0; offset < used;)
+      {
+        auto p = data() + offset;
+        auto size = *reinterpret_cast<size_t*>(p);
+        auto link = reinterpret_cast<RCLink*>(p + sizeof(size_t));
+        fn(link->header());
+        offset += sizeof(size_t) + size;
+      }
+    }
+  };
+
+  struct RegionArena : public Region
   {
     friend struct Region;
 
+  private:
+    ArenaChunk* chunks;
+
+    // Headers that were allocated elsewhere and moved into this region.
+    RCLink foreign;
+    bool finalizing;
+
   protected:
     RegionArena(RegionType type, size_t frame_depth)
-    : RegionRC(type, frame_depth)
+    : Region(type, frame_depth), chunks(nullptr), finalizing(false)
     {
+      foreign.prev = &foreign;
+      foreign.next = &foreign;
       LOG(Trace) << "Created RegionArena @" << this;
     }
 
-    bool is_finalizing()
+  public:
+    Object* object(Class& cls) override;
+    Array* array(uint32_t type_id, size_t size) override;
+
+    void rfree(Header* h) override;
+    void insert(Header* h) override;
+    bool remove(Header* h) override;
+    bool is_finalizing() override;
+    bool begin_finalizing() override;
+    void finalize_contents() override;
+    void release_dead_objects() override;
+
+    ~RegionArena()
     {
-      return true;
+      LOG(Trace) << "Destroyed RegionArena @" << this;
+    }
+
+    // Frees an arena allocation that has left its arena. Only the chunk's
+    // count changes, as the memory is freed with the chunk.
+    static void free_departed(Header* h)
+    {
+      ArenaChunk::release(ArenaChunk::of(h));
+    }
+
+    void trace_fn(auto&& fn) const;
+    void for_each_header(auto&& fn) const;
+
+  private:
+    void* alloc(size_t size);
+    static void* unlinked(void* mem);
+
+    // Returns true if the header was allocated by this arena.
+    bool is_own(Header* h) const
+    {
+      return h->is_arena_alloc() &&
+        (ArenaChunk::of(h)->arena.load(std::memory_order_acquire) == this);
     }
   };
+
+  // Frees a header's memory, wherever it was allocated. An arena allocation
+  // is only freed this way once it has left its arena.
+  inline void free_header(Header* h)
+  {
+    if (h->is_arena_alloc())
+      RegionArena::free_departed(h);
+    else
+      RegionRC::free(h);
+  }
 }
@@ -14,6 +14,7 @@ namespace vbci
     switch (type)
     {
       case RegionType::RegionRC:
+      case RegionType::RegionGC:
         static_cast<const RegionRC*>(this)->trace_fn(fn);
         break;
 
@@ -28,6 +29,7 @@ namespace vbci
     switch (type)
     {
       case RegionType::RegionRC:
+      case RegionType::RegionGC:
         static_cast<const RegionRC*>(this)->for_each_header(fn);
         break;
 
@@ -41,18 +43,54 @@ namespace vbci
   {
     auto& program = Program::get();
 
-    for (auto h : headers)
-    {
+    for_each_header([&](Header* h) {
       if (program.is_array(h->get_type_id()))
         static_cast<Array*>(h)->trace_fn(fn);
       else
         static_cast<Object*>(h)->trace_fn(fn);
-    }
+    });
   }
 
   void RegionRC::for_each_header(auto&& fn) const
   {
-    for (auto h : headers)
+    for (auto link = headers.next; link != &headers;)
+    {
+      auto h = link->header();
+      link = link->next;
       fn(h);
+    }
+  }
+
+  void RegionArena::trace_fn(auto&& fn) const
+  {
+    auto& program = Program::get();
+
+    for_each_header([&](Header* h) {
+      if (program.is_array(h->get_type_id()))
+        static_cast<Array*>(h)->trace_fn(fn);
+      else
+        static_cast<Object*>(h)->trace_fn(fn);
+    });
+  }
+
+  void RegionArena::for_each_header(auto&& fn) const
+  {
+    auto loc = Location(const_cast<RegionArena*>(this));
+
+    for (auto chunk = chunks; chunk; chunk = chunk->next)
+    {
+      chunk->for_each_header([&](Header* h) {
+        // Skip allocations that have left the arena.
+        if (h->location() == loc)
+          fn(h);
+      });
+    }
+
+    for (auto link = foreign.next; link != &foreign;)
+    {
+      auto h = link->header();
+      link = link->next;
+      fn(h);
+    }
   }
 }
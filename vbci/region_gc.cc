@@ -0,0 +1,121 @@
+#include "region_gc.h"
+
+#include "array.h"
+#include "object.h"
+#include "region_ext.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace vbci
+{
+  Object* RegionGC::object(Class& cls)
+  {
+    allocating(cls.size);
+    return RegionRC::object(cls);
+  }
+
+  Array* RegionGC::array(uint32_t type_id, size_t size)
+  {
+    auto content_type_id = Program::get().unarray(type_id);
+    auto rep = Program::get().layout_type_id(content_type_id);
+    allocating(Array::size_of(size, rep.second->size));
+    return RegionRC::array(type_id, size);
+  }
+
+  void RegionGC::allocating(size_t size)
+  {
+    allocated += size;
+
+    if ((allocated < threshold) || collecting || is_finalizing())
+      return;
+
+    collect_cycles();
+  }
+
+  void RegionGC::collect_cycles()
+  {
+    auto& program = Program::get();
+    auto loc = Location(this);
+    collecting = true;
+
+    auto trace = [&](Header* h, auto&& fn) {
+      if (program.is_array(h->get_type_id()))
+        static_cast<Array*>(h)->trace_fn(fn);
+      else
+        static_cast<Object*>(h)->trace_fn(fn);
+    };
+
+    auto adjust_internal = [&](RC delta) {
+      for_each_header([&](Header* h) {
+        trace(h, [&](Header* c) {
+          if (c->location() == loc)
+            c->set_rc(c->get_rc() + delta);
+        });
+      });
+    };
+
+    // Remove the references from inside the region. Any RC that remains comes
+    // from a register, the stack, a cown or another region, so that header is
+    // a root.
+    adjust_internal(RC(-1));
+
+    // Live headers are marked by making their location pending, so tracing
+    // needs no lookup table. A marked header no longer matches the region's
+    // location, so it's only pushed once.
+    auto marked = loc.pending();
+    std::vector<Header*> work;
+
+    for_each_header([&](Header* h) {
+      if (h->get_rc() > 0)
+      {
+        h->set_location(marked);
+        work.push_back(h);
+      }
+    });
+
+    while (!work.empty())
+    {
+      auto h = work.back();
+      work.pop_back();
+
+      trace(h, [&](Header* c) {
+        if (c->location() == loc)
+        {
+          c->set_location(marked);
+          work.push_back(c);
+        }
+      });
+    }
+
+    // Everything unmarked is garbage, which can only be referenced by itself.
+    std::vector<Header*> garbage;
+    size_t live_count = 0;
+    size_t live_size = 0;
+
+    for_each_header([&](Header* h) {
+      if (h->location() == marked)
+      {
+        h->set_location(loc);
+        live_count++;
+        live_size += header_size(h);
+      }
+      else
+      {
+        garbage.push_back(h);
+      }
+    });
+
+    adjust_internal(RC(1));
+
+    LOG(Trace) << "RegionGC @" << this << " traced " << live_count
+               << " live headers, " << garbage.size() << " garbage";
+
+    allocated = 0;
+    threshold = std::max(MinThreshold, live_size * 2);
+    collecting = false;
+
+    if (!garbage.empty())
+      collect_garbage(garbage);
+  }
+}
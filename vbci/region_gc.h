@@ -0,0 +1,43 @@
+#pragma once
+
+#include "region_rc.h"
+
+namespace vbci
+{
+  // A reference counted region that also traces its contents to collect
+  // cycles. A trace runs once enough has been allocated since the last one.
+  struct RegionGC : public RegionRC
+  {
+    friend struct Region;
+
+  private:
+    static constexpr size_t MinThreshold = 256 * 1024;
+
+    size_t allocated;
+    size_t threshold;
+    bool collecting;
+
+  protected:
+    RegionGC(RegionType type, size_t frame_depth)
+    : RegionRC(type, frame_depth),
+      allocated(0),
+      threshold(MinThreshold),
+      collecting(false)
+    {
+      LOG(Trace) << "Created RegionGC @" << this;
+    }
+
+  public:
+    Object* object(Class& cls) override;
+    Array* array(uint32_t type_id, size_t size) override;
+
+    ~RegionGC()
+    {
+      LOG(Trace) << "Destroyed RegionGC @" << this;
+    }
+
+  private:
+    void allocating(size_t size);
+    void collect_cycles();
+  };
+}
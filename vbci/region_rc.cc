@@ -2,15 +2,18 @@
 
 #include "array.h"
 #include "object.h"
+#include "region_arena.h"
+#include "region_ext.h"
 
 namespace vbci
 {
   Object* RegionRC::object(Class& cls)
   {
-    auto mem = new uint8_t[cls.size];
+    auto mem = alloc(cls.size);
     auto loc = Location(this);
     auto obj = Object::create(mem, cls, loc);
-    headers.emplace(obj);
+    finalizable |= cls.needs_finalize();
+    RCLink::of(obj)->link(headers);
     stack_inc();
     return obj;
   }
@@ -19,30 +22,51 @@ namespace vbci
   {
     auto content_type_id = Program::get().unarray(type_id);
     auto rep = Program::get().layout_type_id(content_type_id);
-    auto mem = new uint8_t[Array::size_of(size, rep.second->size)];
+    auto mem = alloc(Array::size_of(size, rep.second->size));
     auto loc = Location(this);
     auto arr =
       Array::create(mem, loc, type_id, rep.first, size, rep.second->size);
-    headers.emplace(arr);
+    finalizable |= Array::needs_finalize(rep.first);
+    RCLink::of(arr)->link(headers);
     stack_inc();
     return arr;
   }
 
+  size_t RegionRC::header_size(Header* h)
+  {
+    if (Program::get().is_array(h->get_type_id()))
+      return static_cast<Array*>(h)->allocation_size_bytes();
+
+    return static_cast<Object*>(h)->allocation_size_bytes();
+  }
+
+  void RegionRC::free(Header* h)
+  {
+    Pool::free(RCLink::of(h), alloc_size(header_size(h)));
+  }
+
   void RegionRC::rfree(Header* h)
   {
-    headers.erase(h);
-    delete[] reinterpret_cast<uint8_t*>(h);
+    remove(h);
+    free_header(h);
   }
 
   void RegionRC::insert(Header* h)
   {
     LOG(Trace) << "Inserting header @" << h << " into RegionRC @" << this;
-    headers.emplace(h);
+    finalizable |= needs_finalize(h);
+    RCLink::of(h)->link(headers);
   }
 
   bool RegionRC::remove(Header* h)
   {
-    return headers.erase(h) != 0;
+    auto link = RCLink::of(h);
+
+    if (!link->is_linked())
+      return false;
+
+    link->unlink();
+    return true;
   }
 
   bool RegionRC::is_finalizing()
@@ -64,19 +88,31 @@ namespace vbci
     auto& program = Program::get();
     assert(finalizing);
 
-    for (auto h : headers)
-    {
+    if (!finalizable)
+      return;
+
+    for_each_header([&](Header* h) {
       if (program.is_array(h->get_type_id()))
         static_cast<Array*>(h)->finalize();
       else
         static_cast<Object*>(h)->finalize();
-    }
+    });
   }
 
   void RegionRC::release_dead_objects()
   {
-    for (auto h : headers)
-      delete[] reinterpret_cast<uint8_t*>(h);
+    Pool::Batch batch;
+
+    for (auto link = headers.next; link != &headers;)
+    {
+      auto h = link->header();
+      link = link->next;
+
+      if (h->is_arena_alloc())
+        free_header(h);
+      else
+        batch.free(RCLink::of(h), alloc_size(header_size(h)));
+    }
 
     delete this;
   }
@@ -1,29 +1,87 @@
 #pragma once
 
+#include "pool.h"
 #include "program.h"
 #include "region.h"
 
 #include <cstdlib>
 #include <iostream>
-#include <unordered_set>
 
 namespace vbci
 {
+  // Every allocation is preceded by a link in a circular list of the headers
+  // in its region. Unlinked headers have null links.
+  struct RCLink
+  {
+    RCLink* prev;
+    RCLink* next;
+
+    static RCLink* of(Header* h)
+    {
+      return reinterpret_cast<RCLink*>(h) - 1;
+    }
+
+    Header* header()
+    {
+      return reinterpret_cast<Header*>(this + 1);
+    }
+
+    bool is_linked() const
+    {
+      return prev != nullptr;
+    }
+
+    void link(RCLink& head)
+    {
+      prev = &head;
+      next = head.next;
+      head.next->prev = this;
+      head.next = this;
+    }
+
+    void unlink()
+    {
+      prev->next = next;
+      next->prev = prev;
+      prev = nullptr;
+      next = nullptr;
+    }
+  };
+
   struct RegionRC : public Region
   {
     friend struct Region;
 
-  private:
-    std::unordered_set<Header*> headers;
+  protected:
+    RCLink headers;
     bool finalizing;
 
   public:
     RegionRC(RegionType type, size_t frame_depth = 0)
     : Region(type, frame_depth), finalizing(false)
     {
+      headers.prev = &headers;
+      headers.next = &headers;
       LOG(Trace) << "Created RegionRC @" << this;
     }
 
+    static size_t alloc_size(size_t size)
+    {
+      return sizeof(RCLink) + size;
+    }
+
+    // Allocates memory for a header, preceded by its link.
+    static void* alloc(size_t size)
+    {
+      auto link = static_cast<RCLink*>(Pool::alloc(alloc_size(size)));
+      link->prev = nullptr;
+      link->next = nullptr;
+      return link + 1;
+    }
+
+    static size_t header_size(Header* h);
+    static void free(Header* h);
+
     Object* object(Class& cls) override;
     Array* array(uint32_t type_id, size_t size) override;
 
@@ -0,0 +1,57 @@
+#include "register_file.h"
+
+#include "vmem.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace vbci
+{
+  RegisterFile::~RegisterFile()
+  {
+    if (!base)
+      return;
+
+    for (auto& reg : *this)
+      reg.~Register();
+
+    vmem::release(base, Reserve);
+  }
+
+  void RegisterFile::grow(size_t size)
+  {
+    if (!base)
+    {
+      base = static_cast<Register*>(vmem::reserve(Reserve));
+
+      if (!base)
+        throw std::bad_alloc();
+    }
+
+    if (size > Capacity)
+      Value::error(Error::StackOverflow);
+
+    // Commit whole steps of address space, and construct every register that
+    // fits in them.
+    auto bytes = size * sizeof(Register);
+    bytes = (bytes + (CommitSize - 1)) & ~(CommitSize - 1);
+    bytes = std::min(bytes, Reserve);
+
+    auto committed = count * sizeof(Register);
+    committed = (committed + (CommitSize - 1)) & ~(CommitSize - 1);
+
+    if (
+      (bytes > committed) &&
+      !vmem::commit(
+        reinterpret_cast<uint8_t*>(base) + committed, bytes - committed))
+      throw std::bad_alloc();
+
+    auto next = bytes / sizeof(Register);
+
+    for (auto i = count; i < next; i++)
+      new (&base[i]) Register();
+
+    count = next;
+  }
+}
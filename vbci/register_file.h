@@ -0,0 +1,70 @@
+#pragma once
+
+#include "register.h"
+
+#include <cstddef>
+
+namespace vbci
+{
+  // Register storage for a thread's frames, in reserved address space. The
+  // file grows in place, so references to registers stay valid across calls
+  // that need more registers.
+  struct RegisterFile
+  {
+  private:
+    static constexpr size_t Reserve = size_t(64) * 1024 * 1024;
+    static constexpr size_t CommitSize = 64 * 1024;
+    static constexpr size_t Capacity = Reserve / sizeof(Register);
+
+    Register* base = nullptr;
+    size_t count = 0;
+
+    void grow(size_t size);
+
+  public:
+    RegisterFile() = default;
+    RegisterFile(const RegisterFile&) = delete;
+    RegisterFile& operator=(const RegisterFile&) = delete;
+    ~RegisterFile();
+
+    size_t size() const
+    {
+      return count;
+    }
+
+    Register* data()
+    {
+      return base;
+    }
+
+    Register* begin()
+    {
+      return base;
+    }
+
+    Register* end()
+    {
+      return base + count;
+    }
+
+    // Makes sure at least `size` registers exist.
+    void ensure(size_t size)
+    {
+      if (size > count)
+        grow(size);
+    }
+
+    Register& operator[](size_t idx)
+    {
+      assert(idx < count);
+      return base[idx];
+    }
+
+    // Returns a register, growing the file if needed.
+    Register& at(size_t idx)
+    {
+      ensure(idx + 1);
+      return base[idx];
+    }
+  };
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <snmalloc/ds_core/defines.h>
+#include <utility>
+#include <vbci.h>
+#include <vector>
+
+namespace vbci
+{
+  // A row-displacement table. Each class has a sparse row, indexed by a
+  // global method or field ID. The rows are overlaid in one shared array,
+  // each at an offset chosen so that no two rows use the same slot. Every
+  // slot records the type ID of its owner, so a lookup is a single indexed
+  // load and a compare. Placement only tries offsets that put a row's lowest
+  // ID on a free slot, and skips runs of used slots through a forwarding
+  // table, so building the table doesn't walk the used slots over and over.
+  template<typename T>
+  struct RowTable
+  {
+    struct Slot
+    {
+      uint32_t owner = DynId;
+      T value{};
+    };
+
+    std::vector<Slot> slots;
+
+    // For a free slot, its own index. For a used slot, a later index to
+    // continue the search for a free slot from.
+    std::vector<size_t> skip;
+
+    // Place a row, sorted by ID, and return its offset.
+    size_t place(uint32_t owner, const std::vector<std::pair<size_t, T>>& row)
+    {
+      if (row.empty())
+        return 0;
+
+      auto min_id = row.front().first;
+      auto i = next_free(min_id);
+
+      while (!fits(i - min_id, row))
+        i = next_free(i + 1);
+
+      auto offset = i - min_id;
+      auto end = offset + row.back().first + 1;
+
+      if (slots.size() < end)
+      {
+        auto size = skip.size();
+        slots.resize(end);
+        skip.resize(end);
+
+        for (auto j = size; j < end; j++)
+          skip[j] = j;
+      }
+
+      for (auto& [id, value] : row)
+      {
+        auto& slot = slots[offset + id];
+        slot.owner = owner;
+        slot.value = value;
+        skip[offset + id] = offset + id + 1;
+      }
+
+      return offset;
+    }
+
+    SNMALLOC_FAST_PATH const T* find(size_t offset, uint32_t owner, size_t id)
+    {
+      auto i = offset + id;
+
+      if (SNMALLOC_UNLIKELY(
+            (id >= slots.size()) || (i >= slots.size()) ||
+            (slots[i].owner != owner)))
+        return nullptr;
+
+      return &slots[i].value;
+    }
+
+    void clear()
+    {
+      slots.clear();
+      skip.clear();
+    }
+
+  private:
+    // The first free slot at or after i. Slots past the end are free.
+    size_t next_free(size_t i)
+    {
+      auto free = i;
+
+      while ((free < skip.size()) && (skip[free] != free))
+        free = skip[free];
+
+      // Point every used slot on the way straight at the free slot.
+      while (i != free)
+      {
+        auto next = skip[i];
+        skip[i] = free;
+        i = next;
+      }
+
+      return free;
+    }
+
+    bool fits(size_t offset, const std::vector<std::pair<size_t, T>>& row)
+    {
+      for (auto& [id, value] : row)
+      {
+        auto i = offset + id;
+
+        if ((i < slots.size()) && (slots[i].owner != DynId))
+          return false;
+      }
+
+      return true;
+    }
+  };
+}
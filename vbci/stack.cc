@@ -4,60 +4,58 @@
 #include "header.h"
 #include "object.h"
 #include "program.h"
+#include "vmem.h"
+
+#include <algorithm>
+#include <new>
+
 namespace vbci
 {
-  Stack::Idx Stack::save()
+  // The guard page is part of the reservation, but is never committed.
+  static constexpr size_t GuardSize = 64 * 1024;
+
+  Stack::~Stack()
   {
-    return top;
+    if (base)
+      vmem::release(base, Reserve + GuardSize);
   }
 
-  void Stack::restore(const Idx& idx)
+  void Stack::commit(size_t size)
   {
-    top = idx;
+    if (!base)
+    {
+      base = static_cast<uint8_t*>(vmem::reserve(Reserve + GuardSize));
+
+      if (!base)
+        throw std::bad_alloc();
+    }
+
+    if (size > Reserve)
+      Value::error(Error::StackOverflow);
+
+    size = (size + (CommitSize - 1)) & ~(CommitSize - 1);
+    size = std::min(size, Reserve);
+
+    if (!vmem::commit(base + committed, size - committed))
+      throw std::bad_alloc();
+
+    committed = size;
   }
 
   void* Stack::alloc(size_t size)
   {
-    auto aligned_size = align_up(size);
-
     // All stack allocations are rounded up to 8-byte alignment so headers and
     // payloads remain naturally aligned for i64 and pointer fields.
+    auto aligned_size = align_up(size);
 
-    if (aligned_size > ChunkSize)
-      return nullptr;
+    if (aligned_size > (Reserve - top))
+      Value::error(Error::StackOverflow);
 
-    if ((top.offset + aligned_size) > ChunkSize)
-    {
-      struct StackMarker : Header
-      {
-        StackMarker() : Header(Location::stack(), StackSentinelTypeId) {}
-      };
-
-      // When this allocation would overflow the current chunk, drop a marker
-      // so walkers know they should stop in this chunk; if no room remains for
-      // the marker, just leave the tail unused.
-      auto remaining = ChunkSize - top.offset;
-
-      if (remaining >= sizeof(StackMarker))
-      {
-        auto* marker = reinterpret_cast<StackMarker*>(
-          chunks.at(top.chunk)->data() + top.offset);
-        new (marker) StackMarker();
-      }
-
-      top.chunk++;
-      top.offset = 0;
-    }
-
-    if (top.chunk >= chunks.size())
-    {
-      chunks.emplace_back(std::make_unique<Chunk>());
-      top.chunk = chunks.size() - 1;
-      top.offset = 0;
-    }
+    if ((top + aligned_size) > committed)
+      commit(top + aligned_size);
 
-    auto ret = &chunks.at(top.chunk)->at(top.offset);
-    top.offset += aligned_size;
+    auto ret = base + top;
+    top += aligned_size;
     return ret;
   }
 
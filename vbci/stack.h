@@ -3,77 +3,67 @@
 #include "header.h"
 #include "ident.h"
 
-#include <array>
 #include <cstdint>
-#include <memory>
-#include <vector>
 
 namespace vbci
 {
+  // A contiguous stack in reserved address space. Pages are committed as the
+  // stack grows, and a guard page past the reservation is never committed.
   struct Stack
   {
     friend struct Thread;
 
-    struct Idx
-    {
-      size_t chunk;
-      size_t offset;
-    };
+    // A byte offset from the base of the stack.
+    using Idx = size_t;
 
   private:
-    static constexpr size_t ChunkSize = 1024;
+    static constexpr size_t Reserve = size_t(64) * 1024 * 1024;
+    static constexpr size_t CommitSize = 64 * 1024;
     static constexpr size_t Align = 8;
     static constexpr size_t align_up(size_t n)
     {
       return (n + (Align - 1)) & ~(Align - 1);
     }
-    using Chunk = std::array<uint8_t, ChunkSize>;
-    std::vector<std::unique_ptr<Chunk>> chunks;
-    Idx top;
+
+    uint8_t* base = nullptr;
+    size_t committed = 0;
+    Idx top = 0;
 
     static size_t size_bytes(Header* h);
+    void commit(size_t size);
 
   public:
-    Idx save();
-    void restore(const Idx& idx);
+    Stack() = default;
+    Stack(const Stack&) = delete;
+    Stack& operator=(const Stack&) = delete;
+    ~Stack();
+
+    Idx save()
+    {
+      return top;
+    }
+
+    void restore(Idx idx)
+    {
+      top = idx;
+    }
+
     void* alloc(size_t size);
     Array* array(Location frame_id, uint32_t type_id, size_t size);
 
     template<typename Fn>
     void visit_headers(Idx start, Idx end, Fn&& fn)
     {
-      for (size_t c = start.chunk; c <= end.chunk && c < chunks.size(); c++)
+      while (start < end)
       {
-        auto offset = (c == start.chunk) ? start.offset : 0;
-        auto limit = (c == end.chunk) ? end.offset : ChunkSize;
-
-        if (offset >= limit)
-          continue;
-
-        auto& chunk = *chunks.at(c);
-
-        while (offset < limit)
-        {
-          auto remaining = limit - offset;
-
-          // Not enough space for even a header; nothing more to read here.
-          if (remaining < sizeof(Header))
-            break;
-
-          auto* h = reinterpret_cast<Header*>(chunk.data() + offset);
-
-          assert(h != nullptr);
-          assert(h->location().is_stack());
+        auto* h = reinterpret_cast<Header*>(base + start);
+        assert(h->location().is_stack());
 
-          // Sentinel marks end of live allocations in this chunk.
-          if (h->get_type_id() == Header::StackSentinelTypeId)
-            break;
+        fn(h);
 
-          fn(h);
-          // Walker steps match the allocator's 8-byte alignment so we skip any
-          // padding inserted at allocation time.
-          offset += align_up(size_bytes(h));
-        }
+        // Walker steps match the allocator's 8-byte alignment so we skip any
+        // padding inserted at allocation time.
+        start += align_up(size_bytes(h));
       }
     }
   };
@@ -1,6 +1,7 @@
 #include "thread.h"
 
 #include "array.h"
+#include "blocking.h"
 #include "callback.h"
 #include "cown.h"
 #include "drag.h"
@@ -11,6 +12,7 @@
 #include "program.h"
 #include "region_ext.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <source_location>
@@ -32,6 +34,13 @@ namespace vbci
   template<typename F, typename... Args>
   static void process(Thread& self, F fun, Args... args);
 
+  // Applies deferred region stack RC and frozen RC decrements.
+  static void reconcile_deferred()
+  {
+    DeferredStackRC::reconcile();
+    DeferredARC::reconcile();
+  }
+
   struct ArgReg
   {
     Register& reg;
@@ -392,16 +401,21 @@ namespace vbci
   {
     auto& t = get();
 
+    // Errors record the pc as an offset in the code section, so that it means
+    // the same thing with or without --predecode.
+    auto pc = t.program->code_pc(t.current_pc);
+
     if (t.frame)
-      return {t.frame->func, t.current_pc};
+      return {t.frame->func, pc};
     else
-      return {t.behavior, t.current_pc};
+      return {t.behavior, pc};
   }
 
-  Thread::Thread() : program(&Program::get()), frame(nullptr), args(0)
+  Thread::Thread()
+  : program(&Program::get()), frame(nullptr), args(0), batching(false)
   {
     frames.reserve(16);
-    locals.resize(1024);
+    locals.ensure(1024);
   }
 
   Region* Thread::frame_region_for_stack(Location stack_loc)
@@ -438,6 +452,10 @@ namespace vbci
     behavior = values[0].function();
     auto& closure = values[1];
 
+    // Behaviours queued from callbacks on other threads aren't batched, as
+    // nothing would schedule them.
+    batching = batch_behaviors;
+
     if (!closure.is_invalid())
     {
       if (closure.is_header())
@@ -504,10 +522,17 @@ namespace vbci
     }
 #endif
 
+    // Queued behaviours must be scheduled before the cowns are released, so
+    // that they are ordered after this behaviour.
+    schedule_batch();
+    batching = false;
+
+    // Releasing the cowns lets other threads use their regions.
+    reconcile_deferred();
     verona::rt::BehaviourCore::finished(work);
   }
 
-  Register Thread::thread_run(Function* func)
+  Register Thread::thread_run(Function* func, bool prechecked)
   {
     auto depth = frames.size();
     Register saved;
@@ -518,7 +543,7 @@ namespace vbci
 
     try
     {
-      pushframe(func, 0);
+      pushframe(func, 0, prechecked);
 
       invariant();
 
@@ -569,8 +594,8 @@ namespace vbci
     for (ssize_t i = frames.size() - 1; i >= 0; i--)
     {
       auto& frame = frames[i];
-      log << "  at " << program->di_function(frame.func) << " (pc=" << frame.pc
-          << ")";
+      log << "  at " << program->di_function(frame.func)
+          << " (pc=" << program->code_pc(frame.pc) << ")";
 
       // print out the locals for this frame
       for (size_t j = 0; j < frame.func->registers; j++)
@@ -624,8 +649,9 @@ namespace vbci
     for (; i >= 0; i--)
     {
       auto& frame = frames[i];
-      auto start_pc = frame.func->labels.at(0);
-      auto pc = frame.pc > start_pc ? frame.pc - 1 : frame.pc;
+      auto start_pc = program->code_pc(frame.func->labels.at(0));
+      auto pc = program->code_pc(frame.pc);
+      pc = pc > start_pc ? pc - 1 : pc;
 
       log << std::endl
           << "  at " << program->di_function(frame.func) << " (pc=" << pc << ")"
@@ -980,144 +1006,172 @@ namespace vbci
         return os << "ArrayFill";
       case Op::ArrayCompare:
         return os << "ArrayCompare";
+      case Op::FFIMany:
+        return os << "FFIMany";
+      case Op::CondEq:
+        return os << "CondEq";
+      case Op::CondNe:
+        return os << "CondNe";
+      case Op::CondLt:
+        return os << "CondLt";
+      case Op::CondLe:
+        return os << "CondLe";
+      case Op::CondGt:
+        return os << "CondGt";
+      case Op::CondGe:
+        return os << "CondGe";
+      case Op::AddConst:
+        return os << "AddConst";
+      case Op::SubConst:
+        return os << "SubConst";
+      case Op::FieldLoad:
+        return os << "FieldLoad";
+      case Op::ArgMoveCallStatic:
+        return os << "ArgMoveCallStatic";
+      case Op::ArgCopyCallStatic:
+        return os << "ArgCopyCallStatic";
       default:
         return os << "Unknown";
     }
   }
 
-  void Thread::step()
+  void Thread::load_const(Register& dst, ValueType t)
   {
-    assert(frame);
-    current_pc = frame->pc;
-    auto op = leb<Op>();
-    auto process =
-      [this](auto f, std::source_location loc = std::source_location::current())
-        INLINE {
-          Operands::process(*this, f);
-          // Check the invariant after running this instruction.
-          invariant(loc);
-        };
-
-    trace_instruction("OP:", op);
-    switch (op)
+    switch (t)
     {
-      case Op::Const:
+      case ValueType::None:
+        dst = ValueImmortal(Value::none());
+        break;
+
+      case ValueType::Bool:
       {
-        process([](Thread& self, Register& dst, Constant<ValueType> t) INLINE {
-          switch (t)
-          {
-            case ValueType::None:
-              dst = ValueImmortal(Value::none());
-              break;
+        auto value = leb<bool>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::Bool:
-            {
-              auto value = self.leb<bool>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::I8:
+      {
+        auto value = leb<int8_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::I8:
-            {
-              auto value = self.leb<int8_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::I16:
+      {
+        auto value = leb<int16_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::I16:
-            {
-              auto value = self.leb<int16_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::I32:
+      {
+        auto value = leb<int32_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::I32:
-            {
-              auto value = self.leb<int32_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::I64:
+      {
+        auto value = leb<int64_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::I64:
-            {
-              auto value = self.leb<int64_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::U8:
+      {
+        auto value = leb<uint8_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::U8:
-            {
-              auto value = self.leb<uint8_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::U16:
+      {
+        auto value = leb<uint16_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::U16:
-            {
-              auto value = self.leb<uint16_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::U32:
+      {
+        auto value = leb<uint32_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::U32:
-            {
-              auto value = self.leb<uint32_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::U64:
+      {
+        auto value = leb<uint64_t>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::U64:
-            {
-              auto value = self.leb<uint64_t>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::ILong:
+      {
+        auto value = leb<int64_t>();
+        dst = Value::from_ffi(t, value);
+        break;
+      }
+      case ValueType::ISize:
+      {
+        auto value = leb<int64_t>();
+        dst = Value::from_ffi(t, value);
+        break;
+      }
 
-            case ValueType::ILong:
-            {
-              auto value = self.leb<int64_t>();
-              dst = Value::from_ffi(t, value);
-              break;
-            }
-            case ValueType::ISize:
-            {
-              auto value = self.leb<int64_t>();
-              dst = Value::from_ffi(t, value);
-              break;
-            }
+      case ValueType::ULong:
+      {
+        auto value = leb<uint64_t>();
+        dst = Value::from_ffi(t, value);
+        break;
+      }
 
-            case ValueType::ULong:
-            {
-              auto value = self.leb<uint64_t>();
-              dst = Value::from_ffi(t, value);
-              break;
-            }
+      case ValueType::USize:
+      {
+        auto value = leb<uint64_t>();
+        dst = Value::from_ffi(t, value);
+        break;
+      }
 
-            case ValueType::USize:
-            {
-              auto value = self.leb<uint64_t>();
-              dst = Value::from_ffi(t, value);
-              break;
-            }
+      case ValueType::F32:
+      {
+        auto value = leb<float>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::F32:
-            {
-              auto value = self.leb<float>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      case ValueType::F64:
+      {
+        auto value = leb<double>();
+        dst = ValueImmortal(value);
+        break;
+      }
 
-            case ValueType::F64:
-            {
-              auto value = self.leb<double>();
-              dst = ValueImmortal(value);
-              break;
-            }
+      default:
+        Value::error(Error::BadConversion);
+    }
+  }
 
-            default:
-              Value::error(Error::BadConversion);
-          }
-        });
+  void Thread::step()
+  {
+    assert(frame);
+    current_pc = frame->pc;
+    auto op = leb<Op>();
+    auto process =
+      [this](auto f, std::source_location loc = std::source_location::current())
+        INLINE {
+          Operands::process(*this, f);
+          // Check the invariant after running this instruction.
+          invariant(loc);
+        };
+
+    trace_instruction("OP:", op);
+    switch (op)
+    {
+      case Op::Const:
+      {
+        process([](Thread& self, Register& dst, Constant<ValueType> t)
+                  INLINE { self.load_const(dst, t); });
         break;
       }
 
@@ -1437,9 +1491,13 @@ namespace vbci
       case Op::LookupDynamic:
       {
         process(
-          [](Register& dst, const Register& src, Constant<size_t> method_id)
-            INLINE {
-              auto f = src->method(method_id);
+          [](
+            Register& dst,
+            const Register& src,
+            Constant<size_t> method_id,
+            Thread& self) INLINE {
+              auto f = self.program->lookup_method(
+                self.current_pc, src.borrow(), method_id);
 
               if (!f)
                 dst = ValueImmortal(Value());
@@ -1519,7 +1577,8 @@ namespace vbci
 
             if (params.at(i) == +ValueType::Ptr)
             {
-              if (!ffi_ptr_compatible(arg))
+              // Blocking calls check their pointer arguments when queued.
+              if (!symbol.is_blocking() && !ffi_ptr_compatible(arg))
               {
                 self.drop_args();
                 Value::error(Error::BadType);
@@ -1534,11 +1593,20 @@ namespace vbci
 
           self.args = 0;
 
+          if (symbol.is_blocking())
+          {
+            self.queue_blocking(dst, symbol, num_args);
+            frame.drop_args(num_args);
+            return;
+          }
+
           // A Value must be passed as a pointer, not as a struct, since it
           // is a C++ non-trivally constructed type.
 
           auto& ffi_arg_addrs = self.ffi_arg_addrs;
           auto& ffi_arg_vals = self.ffi_arg_vals;
+          auto& ffi_var_types = self.ffi_var_types;
+          ffi_var_types.clear();
 
           if (ffi_arg_addrs.size() < num_args)
           {
@@ -1558,7 +1626,7 @@ namespace vbci
             else
             {
               auto rep = program.layout_type_id(arg->type_id());
-              symbol.varparam(rep.second);
+              ffi_var_types.push_back(rep.second);
               vt = rep.first;
             }
 
@@ -1590,7 +1658,7 @@ namespace vbci
             }
           }
 
-          auto ret = symbol.call(ffi_arg_addrs);
+          auto ret = symbol.call(ffi_arg_addrs, ffi_var_types);
 
           if (!ret.is_error() && !program.subtype(ret.type_id(), symbol.ret()))
             Value::error(Error::BadType);
@@ -2128,19 +2196,214 @@ namespace vbci
         break;
       }
 
+      case Op::FFIMany:
+      {
+        process([](
+                  Register& dst,
+                  Constant<size_t> symbol_id,
+                  Thread& self,
+                  Frame& frame,
+                  Program& program) INLINE {
+          auto& symbol = program.symbol(symbol_id);
+          auto& paramvals = symbol.paramvals();
+          auto num_params = paramvals.size();
+
+          // A blocking symbol returns a cown rather than its result, so it
+          // can't fill an array.
+          if (
+            symbol.varargs() || symbol.is_blocking() ||
+            (self.args != (num_params + 1)))
+          {
+            self.drop_args();
+            Value::error(Error::BadArgs);
+          }
+
+          // Every array holds primitives of the matching type, so each
+          // element can be passed to the symbol in place.
+          auto column = [&](size_t i, ValueType vt) -> Array* {
+            auto& arg = frame.arg(i);
+
+            if (!arg->is_array())
+            {
+              self.drop_args();
+              Value::error(Error::BadType);
+            }
+
+            auto arr = arg->get_array();
+
+            if (!arr->is_primitive() || (arr->content_value_type() != vt))
+            {
+              self.drop_args();
+              Value::error(Error::BadType);
+            }
+
+            return arr;
+          };
+
+          auto out = column(0, symbol.retval());
+          auto n = out->get_size();
+
+          // Results are written into the first array, which must be one that
+          // a store could write to.
+          auto out_loc = out->location();
+
+          if (
+            frame.arg(0)->is_readonly() || out_loc.is_immutable() ||
+            out_loc.is_immortal())
+          {
+            self.drop_args();
+            Value::error(Error::BadStoreTarget);
+          }
+
+          for (size_t i = 0; i < num_params; i++)
+          {
+            if (column(i + 1, paramvals.at(i))->get_size() != n)
+            {
+              self.drop_args();
+              Value::error(Error::BadArgs);
+            }
+          }
+
+          auto& ffi_arg_addrs = self.ffi_arg_addrs;
+
+          if (ffi_arg_addrs.size() < num_params)
+          {
+            ffi_arg_addrs.resize(num_params);
+            self.ffi_arg_vals.resize(num_params);
+          }
+
+          for (size_t j = 0; j < n; j++)
+          {
+            for (size_t i = 0; i < num_params; i++)
+              ffi_arg_addrs.at(i) =
+                frame.arg(i + 1)->get_array()->element_pointer(j);
+
+            auto ret = symbol.call(ffi_arg_addrs);
+            ret.to_addr(symbol.retval(), out->element_pointer(j));
+          }
+
+          self.drop_args();
+          dst = ValueImmortal(Value::none());
+        });
+        break;
+      }
+
+#define do_cmpcond(opname) \
+  { \
+    process([]( \
+              Register& dst, \
+              const Register& lhs, \
+              const Register& rhs, \
+              Constant<size_t> on_true, \
+              Constant<size_t> on_false, \
+              Thread& self) INLINE { \
+      dst = ValueImmortal(lhs->op_##opname(rhs.borrow())); \
+      if (dst->get_bool()) \
+        self.branch(on_true); \
+      else \
+        self.branch(on_false); \
+    }); \
+    break; \
+  }
+      case Op::CondEq:
+        do_cmpcond(eq);
+      case Op::CondNe:
+        do_cmpcond(ne);
+      case Op::CondLt:
+        do_cmpcond(lt);
+      case Op::CondLe:
+        do_cmpcond(le);
+      case Op::CondGt:
+        do_cmpcond(gt);
+      case Op::CondGe:
+        do_cmpcond(ge);
+
+      case Op::AddConst:
+      {
+        process([](
+                  Register& dst,
+                  const Register& lhs,
+                  Register& imm,
+                  Constant<ValueType> t,
+                  Thread& self) INLINE {
+          self.load_const(imm, t);
+          dst = ValueImmortal(lhs->op_add(imm.borrow()));
+        });
+        break;
+      }
+
+      case Op::SubConst:
+      {
+        process([](
+                  Register& dst,
+                  const Register& lhs,
+                  Register& imm,
+                  Constant<ValueType> t,
+                  Thread& self) INLINE {
+          self.load_const(imm, t);
+          dst = ValueImmortal(lhs->op_sub(imm.borrow()));
+        });
+        break;
+      }
+
+      case Op::FieldLoad:
+      {
+        process([](
+                  Register& ref,
+                  Register& src,
+                  Constant<size_t> field_id,
+                  Register& dst) INLINE {
+          ref.from_field_ref<false>(src, field_id);
+          dst.from_load(ref);
+        });
+        break;
+      }
+
+      case Op::ArgMoveCallStatic:
+      {
+        process([](
+                  Register src,
+                  ArgReg arg,
+                  Constant<size_t> dst_id,
+                  Function* func,
+                  Thread& self) INLINE {
+          arg = std::move(src);
+          self.pushframe(func, dst_id);
+        });
+        break;
+      }
+
+      case Op::ArgCopyCallStatic:
+      {
+        process([](
+                  const Register& src,
+                  ArgReg arg,
+                  Constant<size_t> dst_id,
+                  Function* func,
+                  Thread& self) INLINE {
+          arg = src;
+          self.pushframe(func, dst_id);
+        });
+        break;
+      }
+
       default:
         Value::error(Error::UnknownOpcode);
     }
   }
 
-  void Thread::pushframe(Function* func, size_t dst)
+  void Thread::pushframe(Function* func, size_t dst, bool prechecked)
   {
     if (!func)
       Value::error(Error::MethodNotFound);
 
     LOG(Trace) << "Call " << program->di_function(func);
 
-    check_args(func->param_types);
+    // The caller has already checked the argument count and types.
+    if (prechecked)
+      args = 0;
+    else
+      check_args(func->param_types);
 
     Location frame_id = Location::stack();
     size_t base = 0;
@@ -2153,11 +2416,12 @@ namespace vbci
       finalize_base = frame->finalize_top;
     }
 
-    // Make sure there's enough register space.
-    auto req_stack_size = base + func->registers;
+    // Calls are a safe point for deferred RC.
+    reconcile_deferred();
 
-    while (locals.size() < req_stack_size)
-      locals.resize(locals.size() * 2);
+    // Make sure there's enough register space. The register file grows in
+    // place, so this doesn't invalidate registers held by the caller.
+    locals.ensure(base + func->registers);
 
     frames.emplace_back(
       func,
@@ -2202,11 +2466,12 @@ namespace vbci
       finalize_base = frame->finalize_top;
     }
 
-    // Make sure there's enough register space.
-    auto req_stack_size = base + func->registers;
+    // Calls are a safe point for deferred RC.
+    reconcile_deferred();
 
-    while (locals.size() < req_stack_size)
-      locals.resize(locals.size() * 2);
+    // Make sure there's enough register space. The register file grows in
+    // place, so this doesn't invalidate registers held by the caller.
+    locals.ensure(base + func->registers);
 
     frames.emplace_back(
       func,
@@ -2276,6 +2541,13 @@ namespace vbci
     teardown();
     frames.pop_back();
 
+    if (dst == CallbackDst)
+    {
+      callback_result = std::move(ret);
+      frame = frames.empty() ? nullptr : &frames.back();
+      return;
+    }
+
     if (frames.empty())
     {
       locals.at(0) = std::move(ret);
@@ -2341,6 +2613,9 @@ namespace vbci
     teardown(true);
     check_args(func->param_types);
 
+    // The new function may use more registers than the old one.
+    locals.ensure(frame->base + func->registers);
+
     // Move arguments back to the current frame.
     bool stack_escape = false;
 
@@ -2386,6 +2661,9 @@ namespace vbci
 
     // Pop the stack.
     stack.restore(frame->save);
+
+    // Returns are a safe point for deferred RC.
+    reconcile_deferred();
   }
 
   void Thread::teardown_all()
@@ -2497,6 +2775,9 @@ namespace vbci
   void
   Thread::queue_behavior(Register& result, uint32_t type_id, Function* func)
   {
+    // The behaviour's cowns and closure leave this thread.
+    reconcile_deferred();
+
     if (func->param_types.size() != args)
       Value::error(Error::BadArgs);
 
@@ -2635,7 +2916,174 @@ namespace vbci
       }
     }
 
-    verona::rt::BehaviourCore::schedule_many(&b, 1);
+    schedule(b);
+  }
+
+  // The arguments to a blocking call, followed by num_args Values.
+  struct BlockingCall
+  {
+    Symbol* symbol;
+    size_t num_args;
+
+    Value* args()
+    {
+      return reinterpret_cast<Value*>(this + 1);
+    }
+  };
+
+  void Thread::queue_blocking(Register& result, Symbol& symbol, size_t num_args)
+  {
+    auto& paramvals = symbol.paramvals();
+    size_t num_cowns = 0;
+
+    // Only scalars and cowns are passed, so nothing leaves this behaviour's
+    // regions. A raw pointer may point into a region, so a pointer parameter
+    // takes a cown instead, and the call is passed a pointer to the cown's
+    // contents. The call acquires the cown, so the contents stay alive and
+    // nothing else touches them until the call returns.
+    for (size_t i = 0; i < num_args; i++)
+    {
+      if (paramvals.at(i) != ValueType::Ptr)
+        continue;
+
+      auto t = frame->arg(i)->type();
+
+      if (t == ValueType::Cown)
+      {
+        num_cowns++;
+      }
+      else if (t != ValueType::None)
+      {
+        frame->drop_args(num_args);
+        Value::error(Error::BadType);
+      }
+    }
+
+    auto result_cown = Cown::create(symbol.blocking_cown());
+    result = ValueTransfer(result_cown);
+
+    // The call's behaviour holds the result cown until the call returns, so
+    // a behaviour on the cown sees the result. Slot 0 is the result cown, and
+    // the rest are the cowns passed to pointer parameters.
+    auto b = verona::rt::BehaviourCore::make(
+      num_cowns + 1,
+      run_blocking,
+      sizeof(BlockingCall) + (sizeof(Value) * num_args));
+    auto slots = b->get_slots();
+    new (&slots[0]) verona::rt::Slot(result_cown);
+
+    auto call =
+      new (b->get_body<BlockingCall>()) BlockingCall{&symbol, num_args};
+    auto args = call->args();
+    size_t slot = 1;
+
+    for (size_t i = 0; i < num_args; i++)
+    {
+      auto& arg = frame->arg(i);
+
+      if (arg->type() == ValueType::None)
+      {
+        new (&args[i]) Value(static_cast<void*>(nullptr));
+        continue;
+      }
+
+      new (&args[i]) Value(arg.borrow());
+
+      if (arg->type() == ValueType::Cown)
+      {
+        auto& s = slots[slot++];
+        new (&s) verona::rt::Slot(arg->get_cown());
+
+        if (arg->is_readonly())
+          s.set_read_only();
+      }
+    }
+
+    schedule(b);
+  }
+
+  void Thread::run_blocking(verona::rt::Work* work)
+  {
+    // Keep the scheduler running until the call returns.
+    verona::rt::Scheduler::add_external_event_source();
+    BlockingPool::submit(finish_blocking, work);
+  }
+
+  void Thread::finish_blocking(void* arg)
+  {
+    auto work = static_cast<verona::rt::Work*>(arg);
+    auto b = verona::rt::BehaviourCore::from_work(work);
+    auto result = static_cast<Cown*>(b->get_slots()[0].cown());
+    auto call = b->get_body<BlockingCall>();
+    auto args = call->args();
+
+    // Reused by every call on this pool thread.
+    static thread_local std::vector<const void*> addrs;
+    static thread_local std::vector<void*> ptrs;
+    addrs.resize(call->num_args);
+    ptrs.resize(call->num_args);
+
+    try
+    {
+      for (size_t i = 0; i < call->num_args; i++)
+      {
+        if (args[i].type() != ValueType::Cown)
+        {
+          addrs[i] = args[i].to_ffi();
+          continue;
+        }
+
+        // The behaviour has acquired the cown, so its contents can't change.
+        auto content = args[i].get_cown()->load();
+
+        if (content.type() == ValueType::Array)
+          ptrs[i] = content.get_array()->get_pointer();
+        else if (content.type() == ValueType::Object)
+          ptrs[i] = content.get_object()->get_pointer();
+        else
+          Value::error(Error::BadType);
+
+        addrs[i] = &ptrs[i];
+      }
+
+      Register r =
+        result->exchange<true>(ValueImmortal(call->symbol->call(addrs)));
+    }
+    catch (Value& error_value)
+    {
+      LOG(Error) << error_value.to_string();
+      Register r = result->exchange<true>(ValueImmortal(error_value));
+    }
+
+    for (size_t i = 0; i < call->num_args; i++)
+      args[i].~Value();
+
+    verona::rt::BehaviourCore::finished(work);
+    verona::rt::Scheduler::remove_external_event_source();
+  }
+
+  void Thread::schedule(verona::rt::BehaviourCore* b)
+  {
+    if (!batching)
+    {
+      verona::rt::BehaviourCore::schedule_many(&b, 1);
+      return;
+    }
+
+    batch.push_back(b);
+
+    if (batch.size() == MaxBatch)
+      schedule_batch();
+  }
+
+  void Thread::schedule_batch()
+  {
+    if (batch.empty())
+      return;
+
+    LOG(Trace) << "Scheduling " << batch.size() << " behaviours";
+    verona::rt::BehaviourCore::schedule_many(batch.data(), batch.size());
+    batch.clear();
   }
 
   Register& Thread::get_register(uint64_t idx)
@@ -2695,9 +3143,34 @@ namespace vbci
       }
     }
 
+    // Only count and time callbacks while stats are being reported, as C
+    // libraries may call back once per element.
+    auto timed = logging::Info::active();
+    std::chrono::steady_clock::time_point start;
+
+    if (timed)
+      start = std::chrono::steady_clock::now();
+
+    // Errors abort below, so unlike thread_run this doesn't unwind frames or
+    // save the caller's result register. The entry frame returns to
+    // callback_result instead.
     try
     {
-      auto result = thread_run(cc->func);
+      auto depth = frames.size();
+      pushframe(cc->func, CallbackDst, cc->prechecked);
+
+      while (depth != frames.size())
+        step();
+
+      Register result = std::move(callback_result);
+
+      if (timed)
+      {
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+        record_callback(cc->prechecked, ns);
+      }
 
       if (cc->return_value_type == ValueType::None)
       {
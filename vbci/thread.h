@@ -6,6 +6,7 @@
 #include "platform.h"
 #include "program.h"
 #include "register.h"
+#include "register_file.h"
 #include "stack.h"
 
 #include <functional>
@@ -25,7 +26,7 @@ namespace vbci
   private:
     Stack stack;
     std::vector<Frame> frames;
-    std::vector<Register> locals;
+    RegisterFile locals;
     std::vector<Object*> finalize;
 
     Program* program;
@@ -36,6 +37,19 @@ namespace vbci
 
     std::vector<const void*> ffi_arg_addrs;
     std::vector<const void*> ffi_arg_vals;
+    std::vector<ffi_type*> ffi_var_types;
+
+    // Behaviours queued by the running behaviour, scheduled together when it
+    // finishes or when the batch is full.
+    static constexpr size_t MaxBatch = 256;
+    static inline bool batch_behaviors = false;
+    std::vector<verona::rt::BehaviourCore*> batch;
+    bool batching;
+
+    // A callback's entry frame returns here rather than to a register in the
+    // frame below, which may belong to the code that made the FFI call.
+    static constexpr size_t CallbackDst = size_t(-1);
+    Register callback_result;
 #ifndef NDEBUG
     logging::Trace instruction_log;
 #endif
@@ -72,6 +86,11 @@ namespace vbci
 
     static std::pair<Function*, PC> debug_info();
 
+    static void set_batch_behaviors(bool value)
+    {
+      batch_behaviors = value;
+    }
+
     // Disable copy semantics
     Thread(const Thread&) = delete;
     Thread& operator=(const Thread&) = delete;
@@ -111,9 +130,9 @@ namespace vbci
 
     void thread_run_behavior(verona::rt::Work* work);
     void thread_handle_callback(CallbackClosure* cc, void* ret, void** args);
-    Register thread_run(Function* func);
+    Register thread_run(Function* func, bool prechecked = false);
     void step();
-    void pushframe(Function* func, size_t dst);
+    void pushframe(Function* func, size_t dst, bool prechecked = false);
     void try_pushframe(Function* func, size_t dst);
     void popframe(Register result);
     void raise(Register result, Location target);
@@ -121,12 +140,18 @@ namespace vbci
     void teardown(bool tailcall = false);
     void teardown_all();
     void branch(size_t label);
+    void load_const(Register& dst, ValueType t);
     void check_args(std::vector<uint32_t>& types, bool vararg = false);
     bool try_check_args(std::vector<uint32_t>& types);
     void check_args(std::vector<Field>& fields);
     Register& arg(size_t idx);
     void drop_args();
     void queue_behavior(Register& result, uint32_t type_id, Function* func);
+    void queue_blocking(Register& result, Symbol& symbol, size_t num_args);
+    static void run_blocking(verona::rt::Work* work);
+    static void finish_blocking(void* arg);
+    void schedule(verona::rt::BehaviourCore* b);
+    void schedule_batch();
 
     void print_stack(logging::Log& log, bool top_frame_only = false);
     void print_error_stack(logging::Log& log, const Value& error_value);
@@ -151,9 +176,9 @@ namespace vbci
       if constexpr (
         (std::is_integral_v<T> && std::is_signed_v<T>) ||
         std::is_floating_point_v<T>)
-        return static_cast<T>(program->sleb(frame->pc));
+        return static_cast<T>(program->soperand(frame->pc));
       else
-        return static_cast<T>(program->uleb(frame->pc));
+        return static_cast<T>(program->operand(frame->pc));
     }
   };
 }
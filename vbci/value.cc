@@ -382,6 +382,8 @@ namespace vbci
 
   bool Value::is_sendable() const
   {
+    DeferredStackRC::reconcile();
+
     switch (tag)
     {
       case ValueType::Object:
@@ -699,7 +701,7 @@ namespace vbci
       {
         auto loc = location();
         if (loc.is_region())
-          loc.to_region()->stack_inc();
+          DeferredStackRC::inc(loc.to_region());
         break;
       }
 
@@ -725,7 +727,7 @@ namespace vbci
       case ValueType::ArrayRef:
       {
         auto loc = location();
-        if (loc.is_region() && !loc.to_region()->stack_dec())
+        if (loc.is_region() && !DeferredStackRC::dec(loc.to_region()))
           return;
         break;
       }
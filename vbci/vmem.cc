@@ -0,0 +1,124 @@
+#include "vmem.h"
+
+#include <vbci.h>
+
+#if defined(PLATFORM_IS_WINDOWS)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace vbci::vmem
+{
+  void* reserve(size_t size)
+  {
+#if defined(PLATFORM_IS_WINDOWS)
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    auto p = mmap(
+      nullptr,
+      size,
+      PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+      -1,
+      0);
+
+    return (p == MAP_FAILED) ? nullptr : p;
+#endif
+  }
+
+  bool commit(void* p, size_t size)
+  {
+#if defined(PLATFORM_IS_WINDOWS)
+    return VirtualAlloc(p, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(p, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+  }
+
+  void release(void* p, size_t size)
+  {
+#if defined(PLATFORM_IS_WINDOWS)
+    (void)size;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, size);
+#endif
+  }
+
+  const void* map_file(const std::filesystem::path& path, size_t& size)
+  {
+    size = 0;
+
+#if defined(PLATFORM_IS_WINDOWS)
+    auto file = CreateFileW(
+      path.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+      return nullptr;
+
+    LARGE_INTEGER file_size;
+    void* p = nullptr;
+
+    if (GetFileSizeEx(file, &file_size) && (file_size.QuadPart > 0))
+    {
+      // The view keeps the mapping alive after its handle is closed.
+      auto mapping =
+        CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+      if (mapping)
+      {
+        p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+      }
+
+      if (p)
+        size = size_t(file_size.QuadPart);
+    }
+
+    CloseHandle(file);
+    return p;
+#else
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+      return nullptr;
+
+    struct stat st;
+    void* p = nullptr;
+
+    // Only regular files can be mapped.
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0))
+    {
+      p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (p == MAP_FAILED)
+        p = nullptr;
+      else
+        size = size_t(st.st_size);
+    }
+
+    close(fd);
+    return p;
+#endif
+  }
+
+  void unmap_file(const void* p, size_t size)
+  {
+#if defined(PLATFORM_IS_WINDOWS)
+    (void)size;
+    UnmapViewOfFile(p);
+#else
+    munmap(const_cast<void*>(p), size);
+#endif
+  }
+}
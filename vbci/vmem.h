@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace vbci::vmem
+{
+  // Reserves address space without backing it with memory. Returns nullptr
+  // on failure.
+  void* reserve(size_t size);
+
+  // Backs part of a reservation with readable, writable memory.
+  bool commit(void* p, size_t size);
+
+  // Releases a whole reservation.
+  void release(void* p, size_t size);
+
+  // Maps a whole file read-only. Returns nullptr on failure, or if the file is
+  // empty.
+  const void* map_file(const std::filesystem::path& path, size_t& size);
+
+  // Unmaps a file mapped by map_file.
+  void unmap_file(const void* p, size_t size);
+}
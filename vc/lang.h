@@ -167,7 +167,8 @@ namespace vc
     | (Symbols <<= (Symbol | Function)++)
     | (Symbol <<=
         SymbolId * (Lhs >>= String) * (Rhs >>= String) *
-        (Vararg >>= Vararg | None) * FFIParams * Type)
+        (Vararg >>= Vararg | None) * (Blocking >>= Blocking | None) *
+        FFIParams * Type)
     | (FFIParams <<= Type++)
     | (Use <<= TypeName)[Include]
     | (TypeAlias <<= Ident * TypeParams * Where * Type)[Ident]
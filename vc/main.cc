@@ -30,6 +30,8 @@ int main(int argc, char** argv)
       vbcc::typecheck(state),
       vbcc::optimize(state),
       vbcc::liveness(state),
+      vbcc::escape(state),
+      vbcc::fuse(state),
     },
     parse};
 
@@ -37,15 +39,26 @@ int main(int argc, char** argv)
   {
     std::filesystem::path path;
     std::filesystem::path bytecode_file;
+    Bytecode& state;
     bool strip = false;
     bool build = false;
 
+    Options(Bytecode& state) : state(state) {}
+
     void configure(CLI::App& cli) override
     {
       cli.add_option(
         "-b,--bytecode", bytecode_file, "Output bytecode to this file.");
       cli.add_flag(
         "-s,--strip", strip, "Strip debug information from the bytecode.");
+      cli.add_flag(
+        "--fuse",
+        state.fuse,
+        "Fuse common op sequences into superinstructions.");
+      cli.add_flag(
+        "--stack-promote",
+        state.stack_promote,
+        "Allocate non-escaping temporaries on the stack.");
 
       cli.callback([this, &cli]() {
         path = cli.get_option("path")->as<std::filesystem::path>();
@@ -72,7 +85,7 @@ int main(int argc, char** argv)
     }
   };
 
-  Options opts;
+  Options opts(*state);
   Driver d(reader, &opts);
 
   git_libgit2_init();
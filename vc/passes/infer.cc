@@ -4147,10 +4147,16 @@ namespace vc
               if ((sym / SymbolId)->location() != sym_name)
                 continue;
 
-              // Forward: return type.
+              // Forward: return type. A blocking call returns a cown that
+              // will hold the result.
               auto ret_type = sym / Type;
               if (!ret_type->empty())
-                merge(dst_loc, clone(ret_type));
+              {
+                if ((sym / Blocking) == Blocking)
+                  merge(dst_loc, cown_type(ret_type));
+                else
+                  merge(dst_loc, clone(ret_type));
+              }
 
               // Backward: param types into args.
               auto ffi_params = sym / FFIParams;
@@ -4172,7 +4172,7 @@ namespace vc
               reified_symbols
                 << (Symbol << clone(sym / SymbolId) << clone(sym / Lhs)
                            << clone(sym / Rhs) << clone(sym / Vararg)
-                           << ffi_params << ret_type);
+                           << clone(sym / Blocking) << ffi_params << ret_type);
 
               return;
             }
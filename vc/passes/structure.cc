@@ -269,8 +269,9 @@ namespace vc
 
         // FFI symbol.
         In(Symbols) * T(Group)
-            << (T(Ident)[Ident] * T(Equals) * T(String)[Lhs] * ~T(String)[Rhs] *
-                ParamsPat[Params] * T(Colon) * (Any * Any++)[Type]) >>
+            << (~T(Ident, "blocking")[Blocking] * T(Ident)[Ident] * T(Equals) *
+                T(String)[Lhs] * ~T(String)[Rhs] * ParamsPat[Params] *
+                T(Colon) * (Any * Any++)[Type]) >>
           [](Match& _) {
             auto params = _(Params);
             Node ffiparams = FFIParams;
@@ -307,7 +308,8 @@ namespace vc
             }
 
             return Symbol << (SymbolId ^ _(Ident)) << _(Lhs)
-                          << (_[Rhs] || String ^ "") << vararg << ffiparams
+                          << (_[Rhs] || String ^ "") << vararg
+                          << (_(Blocking) ? Blocking : None) << ffiparams
                           << (Type << _[Type]);
           },
 